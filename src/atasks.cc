@@ -23,6 +23,8 @@ static YColorName groupingFg(&clrActiveTaskBarApp);
 static YFont normalTaskBarFont;
 static YFont activeTaskBarFont;
 
+YMemPool TaskBarApp::pool("TaskBarApp", sizeof(TaskBarApp), 64);
+
 TaskBarApp::TaskBarApp(ClientData* frame, TaskButton* button) :
     fFrame(frame),
     fButton(button),
@@ -35,6 +37,15 @@ TaskBarApp::~TaskBarApp() {
     fButton->remove(this);
 }
 
+void TaskBarApp::setButton(TaskButton* button) {
+    TaskButton* old = fButton;
+    if (old != button) {
+        fButton = button;
+        button->addApp(this);
+        old->remove(this);
+    }
+}
+
 void TaskBarApp::activate() const {
     bool raise = true;
     bool flash = fButton->flashing() && fFrame->isUrgent();
@@ -87,11 +98,14 @@ mstring TaskBarApp::getIconTitle() {
     return str;
 }
 
+YMemPool TaskButton::pool("TaskButton", sizeof(TaskButton), 32);
+
 TaskButton::TaskButton(TaskPane* taskPane):
     YWindow(taskPane),
     fTaskPane(taskPane),
     fActive(nullptr),
     fTaskGrouping(taskPane->grouping()),
+    fGroupKey(0),
     fRepainted(false),
     fShown(true),
     fFlashing(false),
@@ -185,6 +199,27 @@ void TaskButton::remove(TaskBarApp* tapp) {
     }
 }
 
+// Start or stop grouping. When grouping stops, all apps but
+// the active one are added to leave, to get their own button.
+void TaskButton::setGrouping(int grouping, YArray<TaskBarApp*>& leave) {
+    if (grouping && !fTaskGrouping) {
+        fGroup.clear();
+        if (fActive)
+            fGroup += fActive;
+    }
+    else if (!grouping && fTaskGrouping) {
+        for (IterGroup iter = fGroup.iterator(); ++iter; ) {
+            if (*iter != fActive)
+                leave += *iter;
+        }
+        fGroup.clear();
+    }
+    fTaskGrouping = grouping;
+    fGroupKey = 0;
+    if (visible())
+        repaint();
+}
+
 TaskBarApp* TaskButton::getNextShown(TaskBarApp* tapp) const {
     if (grouping()) {
         int k = tapp ? find(fGroup, tapp) : -1;
@@ -882,37 +917,43 @@ TaskButton* TaskPane::getActiveButton() {
     return tapp ? tapp->button() : nullptr;
 }
 
+// Group by class, or by instance for windows without a class.
+static unsigned groupKey(ClientData* frame) {
+    const ClassHint* hint = frame->classHint();
+    return hint->klass.nonempty() ? 2 * hint->klass.index()
+         : hint->instance.nonempty() ? 2 * hint->instance.index() + 1
+         : 0;
+}
+
+TaskButton*& TaskPane::groupSlot(unsigned key) {
+    while (fGroupIndex.getCount() <= int(key))
+        fGroupIndex.append(nullptr);
+    return fGroupIndex[key];
+}
+
+// A new app joins the last button of its class, as it always did.
+void TaskPane::indexGroup(unsigned key) {
+    TaskButton*& slot = groupSlot(key);
+    slot = nullptr;
+    for (IterTask it = fTasks.reverseIterator(); ++it; ) {
+        if (it->groupKey() == key) {
+            slot = *it;
+            break;
+        }
+    }
+}
+
 TaskBarApp* TaskPane::addApp(ClientData* frame) {
     TaskBarApp* tapp = nullptr;
     TaskButton* task = nullptr;
     TaskButton* make = nullptr;
-    if (grouping()) {
-        const char* klas = frame->classHint()->res_class;
-        const char* name = frame->classHint()->res_name;
-        if (nonempty(klas)) {
-            for (IterTask it = fTasks.reverseIterator(); ++it; ) {
-                const char* hint = it->getFrame()->classHint()->res_class;
-                if (nonempty(hint) && !strcmp(hint, klas)) {
-                    task = *it;
-                    break;
-                }
-            }
-        }
-        else if (nonempty(name)) {
-            for (IterTask it = fTasks.reverseIterator(); ++it; ) {
-                ClassHint* hint = it->getFrame()->classHint();
-                if (isEmpty(hint->res_class) &&
-                    nonempty(hint->res_name) &&
-                    !strcmp(hint->res_name, name))
-                {
-                    task = *it;
-                    break;
-                }
-            }
-        }
+    unsigned key = grouping() ? groupKey(frame) : 0;
+    if (key) {
+        task = groupSlot(key);
     }
     if (task == nullptr) {
         task = make = new TaskButton(this);
+        make->setGroupKey(key);
     }
     if (task) {
         tapp = new TaskBarApp(frame, task);
@@ -920,8 +961,11 @@ TaskBarApp* TaskPane::addApp(ClientData* frame) {
             insert(tapp);
         }
         if (make) {
-            if (tapp)
+            if (tapp) {
                 insert(make);
+                if (key)
+                    indexGroup(key);
+            }
             else
                 delete make;
         }
@@ -940,9 +984,14 @@ void TaskPane::insert(TaskButton* task) {
 }
 
 void TaskPane::remove(TaskButton* button) {
+    unsigned key = button->groupKey();
+    bool indexed = (key && key < unsigned(fGroupIndex.getCount()) &&
+                    fGroupIndex[key] == button);
     if (findRemove(fTasks, button)) {
         relayout();
     }
+    if (indexed)
+        indexGroup(key);
 }
 
 void TaskPane::relayout(bool force) {
@@ -966,21 +1015,61 @@ bool TaskPane::handleTimer(YTimer* t) {
     return false;
 }
 
+// Apply a change of TaskBarGroup to the existing buttons.
+// Only apps which change their button are moved.
 void TaskPane::regroup() {
-    YArray<ClientData*> frames;
-    for (IterApps it = fApps.reverseIterator(); ++it; ) {
-        frames += it->getFrame();
-        it->getFrame()->removeAppStatus();
-    }
-
+    const bool wasGrouping = fTaskGrouping;
     fTaskGrouping = taskBarTaskGrouping;
     fNeedRelayout = true;
-
-    for (auto it = frames.reverseIterator(); ++it; ) {
-        it->updateAppStatus();
+    fGroupIndex.clear();
+
+    YArray<TaskBarApp*> leave;
+    for (IterTask it = fTasks.iterator(); ++it; ) {
+        it->setGrouping(fTaskGrouping, leave);
+    }
+
+    if (fTaskGrouping && !wasGrouping) {
+        // Join each app to the first button of its class.
+        for (IterApps it = fApps.iterator(); ++it; ) {
+            unsigned key = groupKey(it->getFrame());
+            if (key) {
+                TaskButton*& slot = groupSlot(key);
+                if (slot == nullptr) {
+                    slot = it->button();
+                    slot->setGroupKey(key);
+                }
+                else {
+                    it->setButton(slot);
+                }
+            }
+        }
+    }
+    else if (wasGrouping && !fTaskGrouping) {
+        // Apps of other workspaces only have a button when grouping.
+        YArray<ClientData*> hidden;
+        for (IterApps it = fApps.iterator(); ++it; ) {
+            if (it->getShown() == false)
+                hidden += it->getFrame();
+        }
+        for (TaskBarApp* tapp : leave) {
+            if (tapp->getShown()) {
+                TaskButton* task = new TaskButton(this);
+                tapp->setButton(task);
+                insert(task);
+            }
+        }
+        for (ClientData* frame : hidden) {
+            frame->removeAppStatus();
+            frame->updateAppStatus();
+        }
     }
 }
 
+bool TaskPane::needsRelayout() const {
+    return fNeedRelayout ||
+        (fTaskGrouping != taskBarTaskGrouping && !dragging());
+}
+
 void TaskPane::relayoutNow(bool force) {
     if (fTaskGrouping != taskBarTaskGrouping && !dragging())
         regroup();
@@ -995,34 +1084,36 @@ void TaskPane::relayoutNow(bool force) {
     if (width() <= 3)
         return;
 
-    int tc = 0;
-
+    // Evaluate getShown once, as it may scan a group.
+    fShownTasks.shrink(0);
     for (IterTask task = fTasks.iterator(); ++task; ) {
         if (task->getShown())
-            tc++;
+            fShownTasks += *task;
         else
             task->hide();
     }
-    if (tc == 0)
+    if (fShownTasks.isEmpty())
         return;
-    tc = max(tc, taskBarButtonWidthDivisor);
 
+    const int tc = max(fShownTasks.getCount(), taskBarButtonWidthDivisor);
     const int wid = (width() - 2) / tc;
     const int rem = (width() - 2) % tc;
     int x = 0;
-    int lc = 0;
 
-    for (IterTask task = fTasks.iterator(); ++task; ) {
-        if (task->getShown()) {
-            const int w1 = wid + (lc < rem);
-            if (task != dragging()) {
+    // Only buttons which moved or resized are reconfigured.
+    for (int lc = 0; lc < fShownTasks.getCount(); ++lc) {
+        TaskButton* task = fShownTasks[lc];
+        const int w1 = wid + (lc < rem);
+        if (task != dragging()) {
+            if (task->width() != unsigned(w1) || task->height() != height())
                 task->setGeometry(YRect(x, 0, unsigned(w1), height()));
-                task->show();
-            }
-            x += w1;
-            lc++;
+            else if (task->x() != x || task->y() != 0)
+                task->setPosition(x, 0);
+            task->show();
         }
+        x += w1;
     }
+    fShownTasks.shrink(0);
     if (dragging())
         dragging()->show();
 }
@@ -5,6 +5,7 @@
 #include "ytimer.h"
 #include "yaction.h"
 #include "ypopup.h"
+#include "ymempool.h"
 
 class TaskPane;
 class TaskButton;
@@ -17,10 +18,15 @@ class TaskBarApp {
 public:
     TaskBarApp(ClientData* frame, TaskButton* button);
     virtual ~TaskBarApp();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     void activate() const;
     ClientData* getFrame() const { return fFrame; }
     TaskButton* button() const { return fButton; }
+    void setButton(TaskButton* button);
 
     void setShown(bool show);
     bool getShown() const;
@@ -37,6 +43,7 @@ private:
     ClientData* fFrame;
     TaskButton* fButton;
     bool fShown;
+    static YMemPool pool;
 };
 
 class TaskButton:
@@ -48,6 +55,10 @@ class TaskButton:
 public:
     TaskButton(TaskPane* taskPane);
     virtual ~TaskButton();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     void deselect() { selected = 0; }
     void setShown(TaskBarApp* app, bool show);
@@ -83,13 +94,17 @@ public:
     ClientData* getFrame() const { return fActive->getFrame(); }
     TaskPane* taskPane() const { return fTaskPane; }
     int grouping() const { return fTaskGrouping; }
+    void setGrouping(int grouping, YArray<TaskBarApp*>& leave);
+    unsigned groupKey() const { return fGroupKey; }
+    void setGroupKey(unsigned key) { fGroupKey = key; }
     int estimate();
     static unsigned maxHeight();
 
 private:
     TaskPane* fTaskPane;
     TaskBarApp* fActive;
-    const int fTaskGrouping;
+    int fTaskGrouping;
+    unsigned fGroupKey;
     bool fRepainted;
     bool fShown;
     bool fFlashing;
@@ -108,6 +123,7 @@ private:
     YFont getFont();
     static YFont getNormalFont();
     static YFont getActiveFont();
+    static YMemPool pool;
 };
 
 class TaskPane: public YWindow, private YTimerListener {
@@ -129,6 +145,7 @@ public:
     static unsigned maxHeight();
     void relayout(bool force = false);
     void relayoutNow(bool force = false);
+    bool needsRelayout() const;
 
     virtual void configure(const YRect2& r);
     virtual void handleClick(const XButtonEvent& up, int count);
@@ -159,6 +176,13 @@ private:
     typedef YObjectArray<TaskButton> TaskType;
     typedef TaskType::IterType IterTask;
     TaskType fTasks;
+    YArray<TaskButton*> fShownTasks;
+
+    // Buttons by the class symbol of their group, see groupKey.
+    // When several buttons share a key, the last one in fTasks.
+    YArray<TaskButton*> fGroupIndex;
+    TaskButton*& groupSlot(unsigned key);
+    void indexGroup(unsigned key);
 
     lazy<YTimer> fRelayoutTimer;
     virtual bool handleTimer(YTimer* t);
@@ -37,6 +37,8 @@ ref<YImage> TrayApp::taskMinimizedGradient;
 ref<YImage> TrayApp::taskActiveGradient;
 ref<YImage> TrayApp::taskNormalGradient;
 
+YMemPool TrayApp::pool("TrayApp", sizeof(TrayApp), 32);
+
 TrayApp::TrayApp(ClientData *frame, TrayPane *trayPane, YWindow *aParent):
     YWindow(aParent),
     fFrame(frame),
@@ -11,6 +11,7 @@
 #include "ywindow.h"
 #include "ypointer.h"
 #include "ytimer.h"
+#include "ymempool.h"
 
 class TrayPane;
 class ClientData;
@@ -19,6 +20,10 @@ class TrayApp: public YWindow, public YTimerListener {
 public:
     TrayApp(ClientData *frame, TrayPane *trayPane, YWindow *aParent);
     virtual ~TrayApp();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     virtual bool isFocusTraversable();
 
@@ -53,6 +58,7 @@ private:
     static ref<YImage> taskMinimizedGradient;
     static ref<YImage> taskActiveGradient;
     static ref<YImage> taskNormalGradient;
+    static YMemPool pool;
 };
 
 class IAppletContainer;
@@ -72,6 +78,7 @@ public:
 
     void relayout() { fNeedRelayout = true; }
     void relayoutNow();
+    bool needsRelayout() const { return fNeedRelayout; }
 
     virtual void handleClick(const XButtonEvent &up, int count);
     virtual void handleExpose(const XExposeEvent &expose);
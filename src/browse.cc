@@ -44,10 +44,10 @@ void BrowseMenu::updatePopup() {
 
 void BrowseMenu::loadItems() {
     removeAll();
-    for (sdir dir(fPath); dir.next(); ) {
+    for (cachedir dir(fPath); dir.next(); ) {
         upath npath(fPath + dir.entry());
         ObjectMenu *sub = nullptr;
-        if (npath.dirExists())
+        if (dir.isDir())
             sub = new BrowseMenu(app, smActionListener,
                                  getActionListener(), npath);
         DFile *pfile = new DFile(app, dir.entry(), null, npath);
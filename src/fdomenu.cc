@@ -362,78 +362,82 @@ tListMeta no_description = {nullptr,nullptr,nullptr,nullptr};
 
 t_menu_node root(&no_description);
 
+// The parsed contents of one desktop file, as far as the menu needs them.
+// These are produced by the parser threads or read from the cache file.
+struct tAppEntry {
+    gchar *title, *icon, *command, *categories;
+};
+
 // variant with local description data
 struct t_menu_node_app : t_menu_node
 {
     tListMeta description;
-    t_menu_node_app(const tDesktopInfo& dinfo) : t_menu_node(&description),
+    t_menu_node_app(const tAppEntry& entry) : t_menu_node(&description),
             description(no_description) {
-        description.icon = Elvis((const char*) dinfo.get_icon_path(), "-");
-
-        LPCSTR cmdraw = g_app_info_get_commandline((GAppInfo*) dinfo.pInfo);
-        if (!cmdraw || !*cmdraw)
-            return;
+        description.icon = entry.icon;
+        description.title = description.key = entry.title;
+        progCmd = entry.command;
+    }
+};
 
-        description.title = description.key = Elvis(dinfo.get_name(), "<UNKNOWN>");
-
-        // if the strings contains the exe and then only file/url tags that we wouldn't
-        // set anyway, THEN create a simplified version and use it later (if bSimpleCmd is true)
-        // OR use the original command through a wrapper (if bSimpleCmd is false)
-        bool bUseSimplifiedCmd = true;
-        gchar * cmdMod = g_strdup(cmdraw);
-        gchar *pcut = strpbrk(cmdMod, " \f\n\r\t\v");
-
-        if (pcut) {
-            bool bExpectXchar = false;
-            for (gchar *p = pcut; *p && bUseSimplifiedCmd; ++p) {
-                int c = (unsigned) *p;
-                if (bExpectXchar) {
-                    if (strchr("FfuU", c))
-                        bExpectXchar = false;
+// if the strings contains the exe and then only file/url tags that we wouldn't
+// set anyway, THEN create a simplified version and use it later (if bSimpleCmd is true)
+// OR use the original command through a wrapper (if bSimpleCmd is false)
+static gchar* app_command(const tDesktopInfo& dinfo, LPCSTR cmdraw) {
+    bool bUseSimplifiedCmd = true;
+    gchar * cmdMod = g_strdup(cmdraw);
+    gchar *pcut = strpbrk(cmdMod, " \f\n\r\t\v");
+
+    if (pcut) {
+        bool bExpectXchar = false;
+        for (gchar *p = pcut; *p && bUseSimplifiedCmd; ++p) {
+            int c = (unsigned) *p;
+            if (bExpectXchar) {
+                if (strchr("FfuU", c))
+                    bExpectXchar = false;
+                else
+                    bUseSimplifiedCmd = false;
+                continue;
+            } else if (c == '%') {
+                bExpectXchar = true;
+                continue;
+            } else {
+                if (isspace(unsigned(c)))
+                    continue;
+                else {
+                    if (!strchr(p, '%'))
+                        goto cmdMod_is_good_as_is;
                     else
                         bUseSimplifiedCmd = false;
-                    continue;
-                } else if (c == '%') {
-                    bExpectXchar = true;
-                    continue;
-                } else {
-                    if (isspace(unsigned(c)))
-                        continue;
-                    else {
-                        if (!strchr(p, '%'))
-                            goto cmdMod_is_good_as_is;
-                        else
-                            bUseSimplifiedCmd = false;
-                    }
                 }
             }
-
-            if (bExpectXchar)
-                bUseSimplifiedCmd = false;
-            if (bUseSimplifiedCmd)
-                *pcut = '\0';
-            cmdMod_is_good_as_is: ;
         }
 
-        bool bForTerminal = false;
-    #if GLIB_VERSION_CUR_STABLE >= G_ENCODE_VERSION(2, 36)
-        bForTerminal = g_desktop_app_info_get_boolean(dinfo.pInfo, "Terminal");
-    #else
-        // cannot check terminal property, callback is as safe bet
-        bUseSimplifiedCmd = false;
-    #endif
-
-        if (bUseSimplifiedCmd && !bForTerminal) // best case
-            progCmd = cmdMod;
-    #ifdef XTERMCMD
-        else if (bForTerminal && bUseSimplifiedCmd)
-            progCmd = g_strjoin(" ", QUOTE(XTERMCMD), "-e", cmdMod, NULL);
-    #endif
-        else
-            // not simple command or needs a terminal started via launcher callback, or both
-            progCmd = g_strdup_printf("%s \"%s\"", ApplicationName, dinfo.d_file);
+        if (bExpectXchar)
+            bUseSimplifiedCmd = false;
+        if (bUseSimplifiedCmd)
+            *pcut = '\0';
+        cmdMod_is_good_as_is: ;
     }
-};
+
+    bool bForTerminal = false;
+#if GLIB_VERSION_CUR_STABLE >= G_ENCODE_VERSION(2, 36)
+    bForTerminal = g_desktop_app_info_get_boolean(dinfo.pInfo, "Terminal");
+#else
+    // cannot check terminal property, callback is as safe bet
+    bUseSimplifiedCmd = false;
+#endif
+
+    if (bUseSimplifiedCmd && !bForTerminal) // best case
+        return cmdMod;
+#ifdef XTERMCMD
+    if (bForTerminal && bUseSimplifiedCmd)
+        return g_strjoin(" ", QUOTE(XTERMCMD), "-e", cmdMod, NULL);
+#endif
+    // not simple command or needs a terminal started via launcher callback, or both
+    g_free(cmdMod);
+    return g_strdup_printf("%s \"%s\"", ApplicationName, dinfo.d_file);
+}
 
 struct tFromTo { LPCSTR from; LPCSTR to;};
 // match transformations applied by some DEs
@@ -451,8 +455,8 @@ const tFromTo SameIconMap[] = {
         { "AudioVideo", "Audio" },
         { "AudioVideo", "Video" }
 };
-typedef void (*tFuncInsertInfo)(LPCSTR szDesktopFile);
-void pickup_folder_info(LPCSTR szDesktopFile) {
+typedef void (*tFuncInsertInfo)(LPCSTR szDesktopFile, const GStatBuf& st);
+void pickup_folder_info(LPCSTR szDesktopFile, const GStatBuf&) {
     GKeyFile *kf = g_key_file_new();
     auto_raii<GKeyFile*, g_key_file_free> free_kf(kf);
 
@@ -524,24 +528,165 @@ void pickup_folder_info(LPCSTR szDesktopFile) {
     }
 }
 
-void insert_app_info(const char* szDesktopFile) {
+// Runs in the parser threads, which must leave the menu tree alone.
+tAppEntry* parse_app_info(LPCSTR szDesktopFile) {
     tDesktopInfo dinfo(szDesktopFile);
     if (!dinfo.pInfo)
-        return;
+        return nullptr;
 
     LPCSTR pCats = g_desktop_app_info_get_categories(dinfo.pInfo);
     if (!pCats)
         pCats = "Other";
     if (0 == strncmp(pCats, "X-", 2))
-        return;
+        return nullptr;
+
+    LPCSTR cmdraw = g_app_info_get_commandline((GAppInfo*) dinfo.pInfo);
+    if (!cmdraw || !*cmdraw)
+        return nullptr;
 
-    t_menu_node* pNode = new t_menu_node_app(dinfo);
+    tAppEntry* entry = new tAppEntry;
+    entry->title = g_strdup(Elvis(dinfo.get_name(), "<UNKNOWN>"));
+    entry->icon = dinfo.get_icon_path();
+    if (!entry->icon)
+        entry->icon = g_strdup("-");
+    entry->command = app_command(dinfo, cmdraw);
+    entry->categories = g_strdup(pCats);
+    return entry;
+}
+
+void insert_app_entry(const tAppEntry* entry) {
+    t_menu_node* pNode = new t_menu_node_app(*entry);
     // Pigeonholing roughly by guessed menu structure
 
-    gchar **ppCats = g_strsplit(pCats, ";", -1);
+    gchar **ppCats = g_strsplit(entry->categories, ";", -1);
     root.add_by_categories(pNode, ppCats);
     g_strfreev(ppCats);
+}
+
+// The desktop files of the current data folder, and a digest of the
+// names, sizes and mtimes of all desktop files, which keys the cache.
+GPtrArray* found_files;
+GChecksum* found_digest;
+
+void collect_app_file(LPCSTR szDesktopFile, const GStatBuf& st) {
+    g_ptr_array_add(found_files, g_strdup(szDesktopFile));
+    gchar* stamp = g_strdup_printf("%s %ld %ld", szDesktopFile,
+                                   long(st.st_mtime), long(st.st_size));
+    g_checksum_update(found_digest, (const guchar*) stamp, strlen(stamp) + 1);
+    g_free(stamp);
+}
 
+gpointer parse_app_files(gpointer files) {
+    GPtrArray* names = (GPtrArray*) files;
+    GPtrArray* entries = g_ptr_array_new();
+    for (guint i = 0; i < names->len; ++i) {
+        tAppEntry* entry = parse_app_info((LPCSTR) g_ptr_array_index(names, i));
+        if (entry)
+            g_ptr_array_add(entries, entry);
+    }
+    return entries;
+}
+
+// Parse the desktop files of each data folder in a thread of its own.
+// The results are collected in folder order, so that later folders
+// still override earlier ones in the menu.
+GPtrArray* parse_app_folders(const YVec<GPtrArray*>& folders) {
+    YVec<gpointer> results;
+#if GLIB_CHECK_VERSION(2, 32, 0)
+    YVec<GThread*> threads;
+    for (GPtrArray* const * p = folders.data;
+            p < folders.data + folders.size; ++p) {
+        GThread* thread = nullptr;
+        if (1 < folders.size && 0 < (*p)->len)
+            thread = g_thread_try_new("fdoparse", parse_app_files, *p, nullptr);
+        threads.add(thread);
+    }
+    for (size_t i = 0; i < folders.size; ++i) {
+        results.add(threads.data[i] ? g_thread_join(threads.data[i])
+                    : parse_app_files(folders.data[i]));
+    }
+#else
+    for (GPtrArray* const * p = folders.data;
+            p < folders.data + folders.size; ++p) {
+        results.add(parse_app_files(*p));
+    }
+#endif
+
+    GPtrArray* entries = g_ptr_array_new();
+    for (gpointer const * p = results.data;
+            p < results.data + results.size; ++p) {
+        GPtrArray* part = (GPtrArray*) *p;
+        for (guint i = 0; i < part->len; ++i)
+            g_ptr_array_add(entries, g_ptr_array_index(part, i));
+        g_ptr_array_free(part, TRUE);
+    }
+    return entries;
+}
+
+/*
+ * The cache file has a header line with the digest of the desktop files,
+ * then one line per entry with four tab separated and escaped fields.
+ */
+static const char cache_header[] = "icewm-menu-fdo cache 1";
+
+gchar* cache_file_name() {
+    return g_build_filename(g_get_user_cache_dir(), "icewm", "menu-fdo", NULL);
+}
+
+GPtrArray* load_cache(LPCSTR digest) {
+    gchar* path = cache_file_name();
+    auto_gfree free_path(path);
+    gchar* contents = nullptr;
+    if (!g_file_get_contents(path, &contents, nullptr, nullptr))
+        return nullptr;
+    auto_gfree free_contents(contents);
+
+    gchar** lines = g_strsplit(contents, "\n", -1);
+    auto_raii<gchar**, g_strfreev> free_lines(lines);
+    gchar* header = g_strdup_printf("%s %s", cache_header, digest);
+    auto_gfree free_header(header);
+    if (!lines[0] || strcmp(lines[0], header))
+        return nullptr;
+
+    GPtrArray* entries = g_ptr_array_new();
+    for (gchar** line = lines + 1; *line; ++line) {
+        gchar** fields = g_strsplit(*line, "\t", -1);
+        if (g_strv_length(fields) == 4) {
+            tAppEntry* entry = new tAppEntry;
+            entry->title = g_strcompress(fields[0]);
+            entry->icon = g_strcompress(fields[1]);
+            entry->command = g_strcompress(fields[2]);
+            entry->categories = g_strcompress(fields[3]);
+            g_ptr_array_add(entries, entry);
+        }
+        g_strfreev(fields);
+    }
+    return entries;
+}
+
+void save_cache(LPCSTR digest, const GPtrArray* entries) {
+    GString* text = g_string_new(nullptr);
+    g_string_append_printf(text, "%s %s\n", cache_header, digest);
+    for (guint i = 0; i < entries->len; ++i) {
+        const tAppEntry* entry = (const tAppEntry*) g_ptr_array_index(entries, i);
+        const gchar* fields[] = {
+            entry->title, entry->icon, entry->command, entry->categories,
+        };
+        for (unsigned k = 0; k < ACOUNT(fields); ++k) {
+            gchar* escaped = g_strescape(fields[k], nullptr);
+            g_string_append(text, escaped);
+            g_string_append_c(text, k + 1 < ACOUNT(fields) ? '\t' : '\n');
+            g_free(escaped);
+        }
+    }
+
+    gchar* path = cache_file_name();
+    auto_gfree free_path(path);
+    gchar* folder = g_path_get_dirname(path);
+    auto_gfree free_folder(folder);
+    if (0 == g_mkdir_with_parents(folder, 0700))
+        g_file_set_contents(path, text->str, gssize(text->len), nullptr);
+    g_string_free(text, TRUE);
 }
 
 void proc_dir_rec(LPCSTR syspath, unsigned depth,
@@ -582,7 +727,7 @@ void proc_dir_rec(LPCSTR syspath, unsigned depth,
         if (!S_ISREG(buf.st_mode))
             continue;
 
-        process_keyfile(szFullName);
+        process_keyfile(szFullName, buf);
     }
 }
 
@@ -638,6 +783,7 @@ static void help(LPCSTR home, LPCSTR dirs, FILE* out, int xit) {
             "--sep-after\tPrint separator only after contents\n"
             "--no-sep-others\tNo separation of the 'Others' menu point\n"
             "--no-sub-cats\tNo additional subcategories, just one level of menues\n"
+            "--no-cache\tParse all .desktop files and ignore the cache\n"
             "*.desktop\tAny .desktop file to launch the application command from there\n"
             "This program also listens to "
                     "environment variables defined by the\nXDG Base Directory Specification:\n"
@@ -652,11 +798,45 @@ void split_folders(const char* path_string, tCharVec& where) {
     }
 }
 
-void process_apps(const tCharVec& where) {
-    for (const gchar* const * p = where.data; p < where.data + where.size;
-            ++p) {
-        proc_dir_rec(*p, 0, insert_app_info, "applications", "desktop");
+static void add_to_digest(LPCSTR str) {
+    str = Elvis(str, "");
+    g_checksum_update(found_digest, (const guchar*) str, strlen(str) + 1);
+}
+
+// Only the search for desktop files happens on every run. Parsing them
+// is skipped when the cache was written for the same set of files.
+void process_apps(bool use_cache) {
+    found_digest = g_checksum_new(G_CHECKSUM_SHA1);
+    // The languages are those which GKeyFile uses to pick a translation,
+    // from LANGUAGE, LC_ALL, LC_MESSAGES and LANG. An empty string ends
+    // their list.
+    add_to_digest(ApplicationName);
+    for (const gchar* const* lang = g_get_language_names(); *lang; ++lang)
+        add_to_digest(*lang);
+    add_to_digest("");
+    add_to_digest(getenv("XDG_CURRENT_DESKTOP"));
+
+    YVec<GPtrArray*> folders;
+    for (tCharVec** where = sys_home_folders; *where; ++where) {
+        for (const gchar* const * p = (*where)->data;
+                p < (*where)->data + (*where)->size; ++p) {
+            found_files = g_ptr_array_new_with_free_func(g_free);
+            proc_dir_rec(*p, 0, collect_app_file, "applications", "desktop");
+            folders.add(found_files);
+        }
     }
+    found_files = nullptr;
+
+    LPCSTR digest = g_checksum_get_string(found_digest);
+    GPtrArray* entries = use_cache ? load_cache(digest) : nullptr;
+    if (!entries) {
+        entries = parse_app_folders(folders);
+        if (use_cache)
+            save_cache(digest, entries);
+    }
+
+    for (guint i = 0; i < entries->len; ++i)
+        insert_app_entry((const tAppEntry*) g_ptr_array_index(entries, i));
 }
 
 /**
@@ -705,6 +885,7 @@ int main(int argc, LPCSTR *argv) {
         return EXIT_SUCCESS;
     }
 
+    bool use_cache = true;
     for (LPCSTR *pArg = argv + 1; pArg < argv + argc; ++pArg) {
         if (is_version_switch(*pArg))
             print_version_exit(VERSION);
@@ -732,6 +913,10 @@ int main(int argc, LPCSTR *argv) {
             no_sub_cats = true;
             continue;
         }
+        if (is_long_switch(*pArg, "no-cache")) {
+            use_cache = false;
+            continue;
+        }
         // unknown option?
         help(usershare, sysshare, stderr, EXIT_FAILURE);
     }
@@ -743,8 +928,7 @@ int main(int argc, LPCSTR *argv) {
     load_folder_descriptions(sys_folders);
     load_folder_descriptions(home_folders);
 
-    process_apps(sys_folders);
-    process_apps(home_folders);
+    process_apps(use_cache);
 
     root.print();
 
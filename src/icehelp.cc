@@ -536,297 +536,450 @@ node::node_type node::get_type(const char *buf)
     return node::unknown;
 }
 
-static int ignore_comments(FILE *fp) {
-    int c = getc(fp);
-    if (c == '-') {
-        c = getc(fp);
-        if (c == '-') {
-            // comment
-            int n = 0;
-            while ((c = getc(fp)) != EOF) {
-                if (c == '>' && n >= 2) {
-                    break;
-                }
-                n = (c == '-') ? (n + 1) : 0;
-            }
+// Decode the HTML entity in the buffer, which starts with an ampersand.
+// Return a replacement text, or else nullptr when 'c' holds the result.
+static const char* decode_entity(const lowbuffer& entity, int& c) {
+    if (strcmp(entity, "&amp") == 0)
+        c = '&';
+    else if (strcmp(entity, "&lt") == 0)
+        c = '<';
+    else if (strcmp(entity, "&gt") == 0)
+        c = '>';
+    else if (strcmp(entity, "&quot") == 0)
+        c = '"';
+    else if (strcmp(entity, "&nbsp") == 0)
+        c = ' ';    // 32+128;
+    else if (strcmp(entity, "&#160") == 0)
+        c = ' ';    // 32+128;
+    else if (strcmp(entity, "&#8203") == 0)
+        c = ' ';    // 32+128;  zero width space
+    else if (strcmp(entity, "&#8211") == 0
+          || strcmp(entity, "&ndash") == 0)
+        c = '-';    // en dash
+    else if (strcmp(entity, "&#8212") == 0
+          || strcmp(entity, "&mdash") == 0)
+        c = '-';    // em dash
+    else if (strcmp(entity, "&#8217") == 0)
+        c = '\'';   // right single quote
+    else if (strcmp(entity, "&#8220") == 0)
+        return "``"; // left double quotes
+    else if (strcmp(entity, "&#8221") == 0)
+        return "''"; // right double quotes
+    else if (strcmp(entity, "&#8226") == 0
+          || strcmp(entity, "&middot") == 0)
+        c = '*';   // bullet
+    else if (strcmp(entity, "&#8230") == 0
+          || strcmp(entity, "&hellip") == 0)
+        return "..."; // horizontal ellipsis
+    else if (strcmp(entity, "&#8594") == 0)
+        return "->"; // rightwards arrow
+    else if (strcmp(entity, "&copy") == 0)
+        return "(c)"; // copyright symbol
+    else if (strcmp(entity, "&reg") == 0)
+        return "(R)"; // registered sign
+    else if (entity.len() > 2 && !strcmp(entity + 2, "tilde")) {
+        c = entity[1];
+    }
+    else if (entity.len() > 2 && !strcmp(entity + 2, "acute")) {
+        c = entity[1];
+    }
+    else if (entity.len() > 2 && !strcmp(entity + 2, "uml")) {
+        c = entity[1];
+    }
+    else {
+        unsigned special = 0;
+        int len = 0;
+        if (1 == sscanf(entity, "&#%u%n", &special, &len)
+                && len == entity.len()
+                && inrange(special, 32U, 126U))
+        {
+            c = (char) special;
         }
-    }
-    else if (c == '[' && (c = getc(fp)) == 'C') {
-        /* skip over <![CDATA[...]]> */
-        int n = 0;
-        while ((c = getc(fp)) != EOF) {
-            if (c == '>' && n >= 2) {
-                break;
+        else {
+            if (complain) {
+                tlog("unknown special '%s'", (const char *) entity);
             }
-            n = (c == ']') ? (n + 1) : 0;
+            c = ' ';
         }
     }
-    while (c != EOF && c != '>') {
-        c = getc(fp);
-    }
-    return c;
+    return nullptr;
 }
 
-static int non_space(int c, FILE *fp) {
-    while (c != EOF && ASCII::isWhiteSpace(c)) {
-        c = getc(fp);
-    }
-    return c;
+static const char* skip_space(const char* p, const char* e) {
+    while (p < e && SPACE(*p))
+        ++p;
+    return p;
 }
 
-static int getc_non_space(FILE *fp) {
-    return non_space(getc(fp), fp);
+// Return the position after the next 'c', or nullptr if none.
+static const char* skip_past(const char* p, const char* e, int c) {
+    const char* q = (const char *) memchr(p, c, e - p);
+    return q ? q + 1 : nullptr;
 }
 
-static node *parse(FILE *fp, int flags, node *parent, node *&nextsub, node::node_type &close) {
-    flist<node> nodes;
+// An incremental HTML parser, which accepts the document in chunks.
+// The levels of nesting are kept on a stack of frames, which allows
+// parsing to stop at the end of each chunk and to resume with the next.
+// The tree grows in place, so it can be laid out and painted while
+// the remainder of the document is still arriving. The caller owns
+// the tree, which is available from root() as soon as it is nonempty.
+class html_parser {
+public:
+    html_parser();
+    ~html_parser();
 
-    for (int c = getc(fp); c != EOF; c = (c == '<') ? c : getc(fp)) {
-        if (c == '<') {
-            c = getc(fp);
-            if (c == '!') {
-                c = ignore_comments(fp);
-            } else if (c == '/') {
-                // ignore </BR> </P> </LI> ...
-                lowbuffer buf;
+    // Parse all complete tokens, keep incomplete ones for the next chunk.
+    void feed(const char* data, size_t len);
+    // End of input: parse what remains and return the tree.
+    node* finish();
 
-                c = getc_non_space(fp);
-                while (c != EOF && !SPACE(c) && c != '>') {
-                    buf.push(c);
-                    c = getc(fp);
-                }
+    node* root() const { return fRoot; }
+    bool finished() const { return fFinal; }
 
-                node::node_type type = node::get_type(buf);
-                if (type == node::paragraph ||
-                    type == node::line ||
-                    type == node::hrule ||
-                    type == node::link ||
-                    type == node::unknown ||
-                    (type == node::form && (!parent || parent->type != type)) ||
-                    type == node::meta)
-                {
-                }
-                else if (parent) {
-                    close = type;
-                    break;
-                }
-            } else {
-                lowbuffer buf;
+private:
+    class frame {
+    public:
+        frame(node* p, int f, frame* u) : parent(p), flags(f), up(u) { }
+        node* parent;       // the container, or null at the top level
+        int flags;          // PRE and PRE1 for text at this level
+        flist<node> nodes;  // contents of the container
+        frame* up;
+    };
 
-                c = non_space(c, fp);
-                while (c != EOF && !SPACE(c) && c != '>') {
-                    buf.push(c);
-                    c = getc(fp);
-                }
+    char* fBuf;
+    size_t fLen, fCap, fPos;
+    frame* fTop;
+    node* fRoot;
+    bool fFinal;
+    bool fDone;
+
+    bool token();
+    const char* openTag(const char* p, const char* e, node** result);
+    const char* closeTag(const char* p, const char* e, node::node_type* type);
+    const char* comment(const char* p, const char* e);
+    void addText(const char* p, const char* e, bool closing);
+    void add(node* n);
+    void push(node* n);
+    void pop();
+    void open(node* n);
+    void close(node::node_type type);
+};
 
-                node::node_type type = buf.nonempty()
-                                     ? node::get_type(buf) : node::unknown;
-                node *n = new node(type);
-                if (n == nullptr)
-                    break;
-                while ((c = non_space(c, fp)) != '>' && c != EOF) {
-                    lowbuffer abuf;
+html_parser::html_parser() :
+    fBuf(nullptr),
+    fLen(0),
+    fCap(0),
+    fPos(0),
+    fTop(new frame(nullptr, 0, nullptr)),
+    fRoot(nullptr),
+    fFinal(false),
+    fDone(false)
+{
+}
 
-                    while (c != EOF && !SPACE(c) && c != '=' && c != '>') {
-                        abuf.push(c);
-                        c = getc(fp);
-                    }
-                    c = non_space(c, fp);
-                    if (c == '=') {
-                        cbuffer vbuf;
-                        c = getc_non_space(fp);
-                        if (c == '"') {
-                            while ((c = getc(fp)) != EOF && c != '"') {
-                                vbuf.push(c);
-                            }
-                        } else {
-                            while (c != EOF && !SPACE(c) && c != '>') {
-                                vbuf.push(c);
-                                c = getc(fp);
-                            }
-                        }
-                        if (abuf.nonempty())
-                            n->add_attribute(abuf, vbuf);
-                    }
-                }
+html_parser::~html_parser() {
+    while (fTop) {
+        frame* up = fTop->up;
+        delete fTop;
+        fTop = up;
+    }
+    free(fBuf);
+}
 
-                if (type == node::line ||
-                    type == node::hrule ||
-                    type == node::paragraph||
-                    type == node::link ||
-                    type == node::meta)
-                {
-                    nodes.add(n);
-                } else {
-                    node *container = nullptr;
-
-                    if (type == node::li ||
-                        type == node::dt ||
-                        type == node::dd ||
-                        type == node::paragraph ||
-                        type == node::line
-                       )
-                    {
-                        if (parent &&
-                            (parent->type == type ||
-                             (type == node::dd && parent->type == node::dt) ||
-                             (type == node::dt && parent->type == node::dd))
-                           )
-                        {
-                            nextsub = n;
-                            break;
-                        }
-                    }
+void html_parser::feed(const char* data, size_t len) {
+    if (fDone || fFinal)
+        return;
+    if (fCap < fLen + len) {
+        fCap = max(fLen + len, 2 * fCap);
+        fBuf = (char *) realloc(fBuf, fCap);
+    }
+    memcpy(fBuf + fLen, data, len);
+    fLen += len;
 
-                    node *nextsub;
-                    node::node_type close_type;
-                    do {
-                        nextsub = nullptr;
-                        close_type = node::unknown;
-                        int fl = flags;
-                        if (type == node::pre) fl |= PRE | PRE1;
-                        container = parse(fp, fl, n, nextsub, close_type);
-                        if (container)
-                            n->container = container;
-                        nodes.add(n);
-
-                        if (nextsub) {
-                            n = nextsub;
-                        }
-                        if (close_type != node::unknown) {
-                            if (n->type != close_type)
-                                return nodes;
-                        }
-                    } while (nextsub != nullptr);
-                }
-            }
+    while (fDone == false && fPos < fLen && token()) { }
+
+    if (fPos > 0) {
+        fLen -= fPos;
+        memmove(fBuf, fBuf + fPos, fLen);
+        fPos = 0;
+    }
+}
+
+node* html_parser::finish() {
+    fFinal = true;
+    while (fDone == false && fPos < fLen && token()) { }
+    free(fBuf);
+    fBuf = nullptr;
+    fLen = fCap = fPos = 0;
+    fDone = true;
+    return fRoot;
+}
+
+// Parse one token. Return false if it is incomplete.
+bool html_parser::token() {
+    const char* b = fBuf + fPos;
+    const char* e = fBuf + fLen;
+    const char* end = nullptr;
+
+    if (*b != '<') {
+        const char* lt = (const char *) memchr(b, '<', e - b);
+        if (lt == nullptr) {
+            if (fFinal == false)
+                return false;
+            addText(b, e, false);
+            end = e;
+        }
+        else if (lt + 1 < e) {
+            addText(b, lt, lt[1] == '/');
+            end = lt;
+        }
+        else if (fFinal) {
+            addText(b, lt, false);
+            end = lt;
+        }
+    }
+    else if (b + 1 == e) {
+    }
+    else if (b[1] == '!') {
+        end = comment(b + 2, e);
+    }
+    else if (b[1] == '/') {
+        node::node_type type = node::unknown;
+        end = closeTag(b + 2, e, &type);
+        if (end)
+            close(type);
+    }
+    else {
+        node* n = nullptr;
+        end = openTag(b + 1, e, &n);
+        if (end)
+            open(n);
+    }
+
+    if (end == nullptr) {
+        // an incomplete token at the end of input is dropped
+        if (fFinal == false)
+            return false;
+        end = e;
+    }
+    fPos = end - fBuf;
+    return true;
+}
+
+const char* html_parser::comment(const char* p, const char* e) {
+    if (p + 1 >= e)
+        return nullptr;
+    if (p[0] == '-' && p[1] == '-') {
+        int n = 0;
+        for (p += 2; p < e; ++p) {
+            if (*p == '>' && n >= 2)
+                return p + 1;
+            n = (*p == '-') ? (n + 1) : 0;
         }
-        else if (c != '<') {
-            cbuffer buf;
+        return nullptr;
+    }
+    if (p[0] == '[' && p[1] == 'C') {
+        /* skip over <![CDATA[...]]> */
+        int n = 0;
+        for (p += 2; p < e; ++p) {
+            if (*p == '>' && n >= 2)
+                return p + 1;
+            n = (*p == ']') ? (n + 1) : 0;
+        }
+        return nullptr;
+    }
+    if (p[0] == '-' || p[0] == '[')
+        ++p;
+    return skip_past(p, e, '>');
+}
 
-            do {
-                if (c == '&') {
-                    lowbuffer entity;
+const char* html_parser::closeTag(const char* p, const char* e,
+                                  node::node_type* type)
+{
+    lowbuffer buf;
+    for (p = skip_space(p, e); p < e && !SPACE(*p) && *p != '>'; ++p) {
+        buf.push(*p);
+    }
+    p = skip_past(p, e, '>');
+    if (p && buf.nonempty())
+        *type = node::get_type(buf);
+    return p;
+}
 
-                    do {
-                        entity.push(c);
-                        c = getc(fp);
-                    } while (ASCII::isAlnum(c) || c == '#');
-                    if (c != ';')
-                        ungetc(c, fp);
-                    if (strcmp(entity, "&amp") == 0)
-                        c = '&';
-                    else if (strcmp(entity, "&lt") == 0)
-                        c = '<';
-                    else if (strcmp(entity, "&gt") == 0)
-                        c = '>';
-                    else if (strcmp(entity, "&quot") == 0)
-                        c = '"';
-                    else if (strcmp(entity, "&nbsp") == 0)
-                        c = ' ';    // 32+128;
-                    else if (strcmp(entity, "&#160") == 0)
-                        c = ' ';    // 32+128;
-                    else if (strcmp(entity, "&#8203") == 0)
-                        c = ' ';    // 32+128;  zero width space
-                    else if (strcmp(entity, "&#8211") == 0
-                          || strcmp(entity, "&ndash") == 0)
-                        c = '-';    // en dash
-                    else if (strcmp(entity, "&#8212") == 0
-                          || strcmp(entity, "&mdash") == 0)
-                        c = '-';    // em dash
-                    else if (strcmp(entity, "&#8217") == 0)
-                        c = '\'';   // right single quote
-                    else if (strcmp(entity, "&#8220") == 0) {
-                        buf += "``"; // left double quotes
-                        continue;
-                    }
-                    else if (strcmp(entity, "&#8221") == 0) {
-                        buf += "''"; // right double quotes
-                        continue;
-                    }
-                    else if (strcmp(entity, "&#8226") == 0
-                          || strcmp(entity, "&middot") == 0)
-                        c = '*';   // bullet
-                    else if (strcmp(entity, "&#8230") == 0
-                          || strcmp(entity, "&hellip") == 0) {
-                        buf += "..."; // horizontal ellipsis
-                        continue;
-                    }
-                    else if (strcmp(entity, "&#8594") == 0) {
-                        buf += "->"; // rightwards arrow
-                        continue;
-                    }
-                    else if (strcmp(entity, "&copy") == 0) {
-                        buf += "(c)"; // copyright symbol
-                        continue;
-                    }
-                    else if (strcmp(entity, "&reg") == 0) {
-                        buf += "(R)"; // registered sign
-                        continue;
-                    }
-                    else if (entity.len() > 2 && !strcmp(entity + 2, "tilde")) {
-                        c = entity[1];
-                    }
-                    else if (entity.len() > 2 && !strcmp(entity + 2, "acute")) {
-                        c = entity[1];
-                    }
-                    else if (entity.len() > 2 && !strcmp(entity + 2, "uml")) {
-                        c = entity[1];
-                    }
-                    else {
-                        unsigned special = 0;
-                        int len = 0;
-                        if (1 == sscanf(entity, "&#%u%n", &special, &len)
-                                && len == entity.len()
-                                && inrange(special, 32U, 126U))
-                        {
-                            c = (char) special;
-                        }
-                        else {
-                            if (complain) {
-                                tlog("unknown special '%s'", entity.peek());
-                            }
-                            c = ' ';
-                        }
-                    }
-                }
-                if (c == '\r') {
-                    c = getc(fp);
-                    if (c != '\n')
-                        ungetc(c, fp);
-                    c = '\n';
-                }
-                if (!(flags & PRE)) {
-                    if (SPACE(c))
-                        c = ' ';
+const char* html_parser::openTag(const char* p, const char* e,
+                                 node** result)
+{
+    lowbuffer buf;
+    for (p = skip_space(p, e); p < e && !SPACE(*p) && *p != '>'; ++p) {
+        buf.push(*p);
+    }
+
+    node* n = new node(node::unknown);
+    while ((p = skip_space(p, e)) < e && *p != '>') {
+        lowbuffer abuf;
+
+        for (; p < e && !SPACE(*p) && *p != '=' && *p != '>'; ++p) {
+            abuf.push(*p);
+        }
+        p = skip_space(p, e);
+        if (p < e && *p == '=') {
+            cbuffer vbuf;
+            p = skip_space(p + 1, e);
+            if (p < e && *p == '"') {
+                ++p;
+                const char* q = (const char *) memchr(p, '"', e - p);
+                if (q == nullptr) {
+                    p = e;
+                    break;
                 }
-                if ((flags & PRE1) && c == '\n')
-                    ;
-                else if (c != ' ' || (flags & PRE) ||
-                        buf.isEmpty() || buf.last() != ' ')
-                {
-                    buf.push(c);
+                for (; p < q; ++p) {
+                    vbuf.push(*p);
                 }
-                flags &= ~PRE1;
-            } while ((c = getc(fp)) != EOF && c != '<');
-
-            if (c == '<') {
-                int k = getc(fp);
-                if (k == '/') {
-                    if (SPACE(buf.last()))
-                        buf.pop();
+                ++p;
+            } else {
+                for (; p < e && !SPACE(*p) && *p != '>'; ++p) {
+                    vbuf.push(*p);
                 }
-                ungetc(k, fp);
             }
+            if (abuf.nonempty())
+                n->add_attribute(abuf, vbuf);
+        }
+    }
+    if (e <= p) {
+        delete n;
+        return nullptr;
+    }
+    n->type = buf.nonempty() ? node::get_type(buf) : node::unknown;
+    *result = n;
+    return p + 1;
+}
+
+void html_parser::addText(const char* p, const char* e, bool closing) {
+    int flags = fTop->flags;
+    cbuffer buf;
 
-            if (buf.nonempty()) {
-                node *n = new node(node::text);
-                n->txt = buf.release();
-                nodes.add(n);
+    while (p < e) {
+        int c = (unsigned char) *p++;
+        if (c == '&') {
+            lowbuffer entity;
+
+            entity.push(c);
+            while (p < e && (ASCII::isAlnum(*p) || *p == '#')) {
+                entity.push(*p++);
+            }
+            if (p < e && *p == ';')
+                ++p;
+            const char* text = decode_entity(entity, c);
+            if (text) {
+                buf += text;
+                continue;
             }
         }
+        if (c == '\r') {
+            if (p < e && *p == '\n')
+                ++p;
+            c = '\n';
+        }
+        if (!(flags & PRE)) {
+            if (SPACE(c))
+                c = ' ';
+        }
+        if ((flags & PRE1) && c == '\n')
+            ;
+        else if (c != ' ' || (flags & PRE) ||
+                buf.isEmpty() || buf.last() != ' ')
+        {
+            buf.push(c);
+        }
+        flags &= ~PRE1;
+    }
+    fTop->flags = flags;
+
+    if (closing && SPACE(buf.last()))
+        buf.pop();
+
+    if (buf.nonempty()) {
+        node* n = new node(node::text);
+        n->txt = buf.release();
+        add(n);
+    }
+}
+
+void html_parser::add(node* n) {
+    fTop->nodes.add(n);
+    if (fTop->nodes.first() == n) {
+        if (fTop->parent)
+            fTop->parent->container = n;
+        else
+            fRoot = n;
+    }
+}
+
+// Add a container and descend into it.
+void html_parser::push(node* n) {
+    add(n);
+    int flags = fTop->flags;
+    if (n->type == node::pre)
+        flags |= PRE | PRE1;
+    fTop = new frame(n, flags, fTop);
+}
+
+// Return from the current container to the enclosing level.
+void html_parser::pop() {
+    frame* up = fTop->up;
+    delete fTop;
+    fTop = up;
+}
+
+void html_parser::open(node* n) {
+    node::node_type type = n->type;
+    if (type == node::line ||
+        type == node::hrule ||
+        type == node::paragraph||
+        type == node::link ||
+        type == node::meta)
+    {
+        add(n);
+        return;
+    }
+
+    node* parent = fTop->parent;
+    if ((type == node::li || type == node::dt || type == node::dd) &&
+        parent &&
+        (parent->type == type ||
+         (type == node::dd && parent->type == node::dt) ||
+         (type == node::dt && parent->type == node::dd))
+       )
+    {
+        // an implicit close of the previous item
+        pop();
+    }
+    push(n);
+}
+
+void html_parser::close(node::node_type type) {
+    // ignore </BR> </P> </LI> ...
+    node* parent = fTop->parent;
+    if (type == node::paragraph ||
+        type == node::line ||
+        type == node::hrule ||
+        type == node::link ||
+        type == node::unknown ||
+        (type == node::form && (!parent || parent->type != type)) ||
+        type == node::meta ||
+        parent == nullptr)
+    {
+        return;
+    }
+
+    pop();
+    if (parent->type != type) {
+        // unbalanced: the enclosing container ends too
+        if (fTop->up)
+            pop();
+        else
+            fDone = true;
     }
-    return nodes;
 }
 
 class History {
@@ -999,18 +1152,31 @@ public:
         prevURL = null;
         contentsURL = null;
 
+        find_links();
+
+        actionIndex->setEnabled(history.hasFirst());
+        actionLeft->setEnabled(history.hasLeft());
+        actionRight->setEnabled(history.hasRight());
+    }
+
+    // The document has grown: layout again, but keep the position.
+    void refresh() {
+        layout();
+        find_links();
+        repaint();
+    }
+
+    node *root() const { return fRoot; }
+
+    void find_links() {
         find_link(fRoot);
-        if (contentsURL == null) {
+        if (contentsURL == null && fRoot) {
             node *n = fRoot->find_attr(attr::id | attr::name, "toc");
             if (n) {
                 contentsURL = "#toc";
                 actionContents->setEnabled(true);
             }
         }
-
-        actionIndex->setEnabled(history.hasFirst());
-        actionLeft->setEnabled(history.hasLeft());
-        actionRight->setEnabled(history.hasRight());
     }
 
 
@@ -1434,7 +1600,7 @@ void HTextView::find_link(node *n) {
 }
 
 void HTextView::find_fragment(const char *frag) {
-    node *n = fRoot->find_attr(attr::id | attr::name, frag);
+    node *n = fRoot ? fRoot->find_attr(attr::id | attr::name, frag) : nullptr;
     if (n) {
         int y = max(0, min(n->yr, (int) contentHeight() - (int) height()));
         setPos(0, y);
@@ -2009,10 +2175,46 @@ void HTextView::handleClick(const XButtonEvent &up, int /*count*/) {
     }
 }
 
-class FileView: public YDndWindow, public HTListener {
+class FileView;
+
+// Read a document from a file or a pipe and feed it to the parser,
+// one chunk per iteration of the main loop.
+class html_stream : public YPoll<FileView> {
+public:
+    html_stream(FileView *view, int fd, int pid = 0) :
+        YPoll(view), fPid(pid)
+    {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        registerPoll(fd);
+    }
+    ~html_stream() {
+        closePoll();
+        if (fPid > 0) {
+            // The downloader leads a process group of its own.
+            kill(-fPid, SIGTERM);
+            reap();
+        }
+    }
+
+    html_parser parser;
+
+    void notifyRead() override;
+    bool forRead() override { return true; }
+
+private:
+    int fPid;
+
+    void reap() {
+        while (waitpid(fPid, nullptr, 0) == -1 && errno == EINTR) { }
+        fPid = 0;
+    }
+};
+
+class FileView: public YDndWindow, public HTListener, public YTimerListener {
 public:
     FileView(YApplication *app, int argc, char **argv);
     ~FileView() {
+        delete fStream;
         delete view;
         delete scroll;
         FontTable::reset();
@@ -2022,6 +2224,8 @@ public:
 
     void activateURL(mstring url, bool relative = false) override;
     void openBrowser(mstring url) override;
+    void streamUpdate(bool done);
+    bool handleTimer(YTimer *timer) override;
 
     void configure(const YRect2& r) override {
         if (r.resized()) {
@@ -2044,6 +2248,8 @@ public:
 private:
     bool loadFile(upath path);
     bool loadHttp(upath path);
+    void loadStream(int fd, int pid = 0);
+    void cancelStream();
     void invalidPath(upath path, const char *reason);
     void run(const char* path, const char* arg1 = nullptr,
              const char* arg2 = nullptr, const char* arg3 = nullptr);
@@ -2053,16 +2259,21 @@ private:
     }
 
     upath fPath;
+    mstring fFragment;
     YApplication *app;
 
     HTextView *view;
     YScrollView *scroll;
+    html_stream *fStream;
+    lazy<YTimer> fRefreshTimer;
+    bool fStreamGrew;
     ref<YPixmap> small_icon;
     ref<YPixmap> large_icon;
 };
 
 FileView::FileView(YApplication *iapp, int argc, char **argv)
-    : fPath(), app(iapp), view(nullptr), scroll(nullptr)
+    : fPath(), app(iapp), view(nullptr), scroll(nullptr), fStream(nullptr),
+    fStreamGrew(false)
 {
     setDND(true);
     setStyle(wsNoExpose);
@@ -2143,6 +2354,9 @@ void FileView::activateURL(mstring url, bool relative) {
         path.length() + frag.length() == 0) {
         return; // empty
     }
+    if (path.length() > 0) {
+        cancelStream();
+    }
 
     if (relative && path.nonempty() && false == upath(path).hasProtocol()) {
         if (upath(path).isRelative()) {
@@ -2186,7 +2400,11 @@ void FileView::activateURL(mstring url, bool relative) {
             return;
         }
     }
-    if (frag.length() > 0 && view->contentHeight() > view->height()) {
+    if (fStream && fStream->parser.finished() == false) {
+        // search when the document is complete
+        fFragment = frag;
+    }
+    else if (frag.length() > 0 && view->contentHeight() > view->height()) {
         // search
         view->find_fragment(frag);
     }
@@ -2285,57 +2503,97 @@ bool FileView::loadFile(upath path) {
         invalidPath(path, _("Path does not refer to a file."));
         return false;
     }
-    FILE *fp = fopen(path.string(), "r");
-    if (fp == nullptr) {
+    int fd = path.open(O_RDONLY);
+    if (fd == -1) {
         invalidPath(path, _("Failed to open file for reading."));
         return false;
     }
-    node *nextsub = nullptr;
-    node::node_type close_type = node::unknown;
-    node *root = parse(fp, 0, nullptr, nextsub, close_type);
-    assert(nextsub == 0);
-    fclose(fp);
-    dump_tree(0, root);
-    view->setData(root);
+    loadStream(fd);
     return true;
 }
 
-class temp_file {
-private:
-    FILE *fp;
-    cbuffer cbuf;
-    bool init(const char *tdir) {
-        cbuf = (upath(tdir) + "iceXXXXXX").string();
-        int fd = mkstemp(cbuf.peek());
-        if (fd >= 0) fp = fdopen(fd, "w+b");
-        return fp;
-    }
-    temp_file(const temp_file&);
-    temp_file& operator=(const temp_file&);
-public:
-    temp_file() : fp(nullptr) {
-        const char *tenv = getenv("TMPDIR");
-        if ((tenv && init(tenv)) || init("/tmp") || init("/var/tmp")) ;
-        else tlog(_("Failed to create a temporary file"));
-    }
-    ~temp_file() {
-        unlink(cbuf.peek());
-        if (fp) fclose(fp);
-    }
-    operator bool() const { return fp != nullptr; }
-    int fildes() const { return fileno(fp); }
-    FILE *filep() const { return fp; }
-    const char *path() const { return cbuf; }
-    int size() const {
-        struct stat b;
-        return fstat(fildes(), &b) >= 0 ? (int) b.st_size : 0;
-    }
-    void rewind() const { ::rewind(fp); }
-};
+void FileView::loadStream(int fd, int pid) {
+    cancelStream();
+    fFragment = null;
+    fStream = new html_stream(this, fd, pid);
+}
+
+void FileView::cancelStream() {
+    if (fStream) {
+        delete fStream;
+        fStream = nullptr;
+    }
+    fRefreshTimer = null;
+}
+
+void html_stream::notifyRead() {
+    char buf[16 * 1024];
+    ssize_t len = read(fd(), buf, sizeof buf);
+    if (len < 0 && (errno == EINTR || errno == EAGAIN)) {
+        return;
+    }
+    if (len > 0) {
+        parser.feed(buf, size_t(len));
+        owner()->streamUpdate(false);
+    } else {
+        closePoll();
+        if (fPid > 0)
+            reap();
+        parser.finish();
+        owner()->streamUpdate(true);
+    }
+}
+
+// Show the first screen as soon as it is available,
+// then layout again periodically while the document grows.
+void FileView::streamUpdate(bool done) {
+    node *root = fStream->parser.root();
+    if (root && root != view->root()) {
+        view->setData(root);
+        view->repaint();
+    }
+    else if (done) {
+        fRefreshTimer = null;
+        if (root == nullptr) {
+            invalidPath(fPath, _("The document is empty."));
+            return;
+        }
+        view->refresh();
+    }
+    else if (root && view->contentHeight() <= view->height()) {
+        view->refresh();
+    }
+    else if (root) {
+        fStreamGrew = true;
+        if (fRefreshTimer == nullptr)
+            fRefreshTimer->setTimer(250L, this, true);
+    }
+
+    if (done) {
+        dump_tree(0, root);
+        if (fFragment.nonempty()) {
+            if (view->contentHeight() > view->height())
+                view->find_fragment(fFragment);
+            fFragment = null;
+            view->repaint();
+        }
+    }
+}
+
+bool FileView::handleTimer(YTimer *timer) {
+    if (timer == fRefreshTimer) {
+        if (fStreamGrew) {
+            fStreamGrew = false;
+            view->refresh();
+        }
+        return fStream != nullptr;
+    }
+    return false;
+}
 
 class downloader {
 private:
-    mstring curl, wget, gzip, cat;
+    mstring curl, wget, gzip;
     void test(mstring *mst, const mstring& dir, const char *exe) {
         if (mst->isEmpty()) {
             upath bin = upath(dir) + exe;
@@ -2345,8 +2603,7 @@ private:
         }
     }
     bool empty() const {
-        return curl.isEmpty() || wget.isEmpty()
-            || gzip.isEmpty() || cat.isEmpty();
+        return curl.isEmpty() || wget.isEmpty() || gzip.isEmpty();
     }
     void init() {
         const char defp[] = "/usr/bin:/bin:/usr/sbin:/sbin:/usr/local/bin";
@@ -2358,7 +2615,6 @@ private:
             test(&curl, mdir, "curl");
             test(&wget, mdir, "wget");
             test(&gzip, mdir, "gzip");
-            test(&cat, mdir, "cat");
         }
     }
     downloader(const downloader&);
@@ -2368,72 +2624,137 @@ public:
     operator bool() const {
         return curl.nonempty() || wget.nonempty();
     }
-    bool downloadTo(const char *remote, const temp_file& local) {
-        mstring cmd;
+    // Start a download to a pipe, from which the document can be read
+    // while it is being transferred. Return the read end of the pipe.
+    int download(const char *remote, int *pid) {
+        const char *args[8] = { nullptr, };
         if (curl.nonempty()) {
-            cmd = curl + " --compressed --location -s -o ";
+            const char *opts[] = {
+                curl, "--compressed", "--location", "-s", remote, nullptr
+            };
+            memcpy(args, opts, sizeof opts);
         }
         else if (wget.nonempty()) {
-            cmd = wget + " -q -k -O ";
+            const char *opts[] = {
+                wget, "-q", "-O", "-", remote, nullptr
+            };
+            memcpy(args, opts, sizeof opts);
         }
         else {
-            return false;
+            return -1;
         }
-        cmd = cmd + "'" + local.path() + "' '" + remote + "'";
-        if (!command(cmd)) {
-            return false;
+        int fds[2];
+        if (pipe(fds) == -1) {
+            fail("pipe");
+            return -1;
         }
-        local.rewind();
-        if (is_compressed(local.fildes())) {
-            if (decompress(local) == false) {
-                return false;
+        *pid = fork();
+        if (*pid == 0) {
+            setpgid(0, 0);
+            close(fds[0]);
+            if (fds[1] != 1) {
+                dup2(fds[1], 1);
+                close(fds[1]);
             }
+            _exit(transfer(args, remote));
         }
-        local.rewind();
-        return true;
+        close(fds[1]);
+        if (*pid == -1) {
+            fail("fork");
+            close(fds[0]);
+            return -1;
+        }
+        return fds[0];
+    }
+    // Start a program with a pipe to its stdin or from its stdout.
+    static int spawn(const char **args, bool toStdin, int *pid) {
+        int fds[2];
+        if (pipe(fds) == -1) {
+            fail("pipe");
+            return -1;
+        }
+        const int mine = toStdin ? fds[1] : fds[0];
+        const int theirs = toStdin ? fds[0] : fds[1];
+        const int target = toStdin ? 0 : 1;
+        *pid = fork();
+        if (*pid == 0) {
+            close(mine);
+            if (theirs != target) {
+                dup2(theirs, target);
+                close(theirs);
+            }
+            execv(args[0], const_cast<char **>(args));
+            fail(_("Failed to execute %s"), args[0]);
+            _exit(99);
+        }
+        close(theirs);
+        if (*pid == -1) {
+            fail("fork");
+            close(mine);
+            return -1;
+        }
+        return mine;
     }
-    static bool is_safe(const char *url) {
-        for (const char *p = url; *p; ++p) {
-            if (!ASCII::isAlnum(*p) && !strchr(":/.+-_@%?&=", *p)) {
+    static ssize_t readSome(int fd, char *buf, size_t size) {
+        ssize_t len;
+        while ((len = read(fd, buf, size)) == -1 && errno == EINTR) { }
+        return len;
+    }
+    static bool writeAll(int fd, const char *buf, size_t size) {
+        while (size > 0) {
+            ssize_t len = write(fd, buf, size);
+            if (len > 0) {
+                buf += len;
+                size -= size_t(len);
+            }
+            else if (len == -1 && errno != EINTR) {
                 return false;
             }
         }
         return true;
     }
-    static bool is_compressed(int fd) {
-        char b[3];
-        return filereader(fd, false).read_all(BUFNSIZE(b)) >= 2
-            && b[0] == '\x1F' && b[1] == '\x8B';
-    }
-    static bool command(mstring mcmd) {
-        const char *cmd = mcmd;
-        int xit = ::system(cmd);
-        if (xit) {
-            tlog(_("Failed to execute system(%s) (%d)"), cmd, xit);
-            return false;
+    // Runs in a child: copy the download to stdout.
+    // Documents which are compressed by gzip are decompressed.
+    int transfer(const char **args, const char *remote) {
+        int getter = 0, unzipper = 0;
+        int input = spawn(args, false, &getter);
+        if (input == -1)
+            return 99;
+        fcntl(input, F_SETFD, FD_CLOEXEC);
+
+        char buf[16 * 1024];
+        ssize_t len = readSome(input, buf, sizeof buf);
+        int output = 1;
+        if (len >= 2 && buf[0] == '\x1F' && buf[1] == '\x8B') {
+            const char *unzip[] = { gzip, "-d", "-c", nullptr };
+            if (gzip.isEmpty() ||
+                (output = spawn(unzip, true, &unzipper)) == -1)
+            {
+                tlog(_("Failed to decompress %s"), remote);
+                return 99;
+            }
+            close(1);
         }
-        // tlog("Executed system(%s) OK!", cmd);
-        return true;
+        while (len > 0 && writeAll(output, buf, size_t(len))) {
+            len = readSome(input, buf, sizeof buf);
+        }
+        close(input);
+        close(output);
+
+        int status = 0, unzipped = 0;
+        waitpid(getter, &status, 0);
+        if (unzipper > 0 && waitpid(unzipper, &unzipped, 0) == unzipper &&
+            unzipped != 0)
+            status = unzipped;
+        return WIFEXITED(status) ? WEXITSTATUS(status) : 99;
     }
-    bool decompress(const temp_file& local) {
-        if (gzip.nonempty() && cat.nonempty()) {
-            temp_file temp;
-            if (temp) {
-                mstring cmd = gzip + " -d -c <'";
-                cmd = cmd + local.path() + "' >'";
-                cmd = cmd + temp.path() + "'";
-                if (command(cmd)) {
-                    cmd = cat + "<'" + temp.path() + "' >'";
-                    cmd = cmd + local.path() + "'";
-                    if (command(cmd)) {
-                        local.rewind();
-                        return true;
-                    }
-                }
+    static bool is_safe(const char *url) {
+        for (const char *p = url; *p; ++p) {
+            if (!ASCII::isAlnum(*p) && !strchr(":/.+-_@%?&=", *p)) {
+                return false;
             }
         }
-        tlog(_("Failed to decompress %s"), local.path());
-        return false;
+        return true;
     }
 };
 
@@ -2447,14 +2768,49 @@ bool FileView::loadHttp(upath path) {
         invalidPath(path, _("Unsafe characters in URL"));
         return false;
     }
-    temp_file temp;
-    if (!temp) {
+    int pid = 0;
+    int fd = loader.download(path.string(), &pid);
+    if (fd == -1) {
         return false;
     }
-    if (loader.downloadTo(path.string(), temp)) {
-        return loadFile(temp.path());
+    loadStream(fd, pid);
+    return true;
+}
+
+static int count_nodes(node *n) {
+    int count = 0;
+    for (; n; n = n->next) {
+        count += 1 + count_nodes(n->container);
     }
-    return false;
+    return count;
+}
+
+// Parse a document repeatedly in small chunks and report the speed.
+static void benchmark(const char *path) {
+    fcsmart text(upath(path).loadText());
+    if (text == nullptr) {
+        fail(_("Failed to open %s"), path);
+        exit(1);
+    }
+    const size_t size = strlen(text);
+    const size_t chunk = 4096;
+    const int rounds = 20;
+    int count = 0;
+
+    timeval start = monotime();
+    for (int i = 0; i < rounds; ++i) {
+        html_parser parser;
+        for (size_t k = 0; k < size; k += chunk) {
+            parser.feed(text + k, min(chunk, size - k));
+        }
+        node *root = parser.finish();
+        count = count_nodes(root);
+        delete root;
+    }
+    double elapsed = toDouble(monotime() - start);
+
+    printf("%s: %zu bytes, %d nodes, %.3f ms per parse\n",
+           path, size, count, 1000.0 * elapsed / rounds);
 }
 
 static int handler(Display *display, XErrorEvent *xev) {
@@ -2522,7 +2878,7 @@ static void print_help()
 int main(int argc, char **argv) {
     YLocale locale;
     const char *helpfile(nullptr);
-    bool nodelete = false, netping = false;
+    bool nodelete = false, netping = false, bench = false;
 
     for (char **arg = 1 + argv; arg < argv + argc; ++arg) {
         if (**arg == '-') {
@@ -2562,6 +2918,8 @@ int main(int argc, char **argv) {
                 netping = true;
             else if (is_long_switch(*arg, "verbose"))
                 verbose = true;
+            else if (is_long_switch(*arg, "bench"))
+                bench = true;
             else if (is_long_switch(*arg, "sync")) {
                 YXApplication::synchronizeX11 = true; }
             else if (is_long_switch(*arg, "logevents"))
@@ -2589,6 +2947,10 @@ int main(int argc, char **argv) {
     if (helpfile == nullptr) {
         helpfile = ICEHELPIDX;
     }
+    if (bench) {
+        benchmark(helpfile);
+        return 0;
+    }
 
     XSetErrorHandler(handler);
     YXApplication app(&argc, &argv);
@@ -18,10 +18,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <signal.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <vector>
 #include <algorithm>
 
@@ -36,6 +40,9 @@
 #ifdef XINERAMA
 #include <X11/extensions/Xinerama.h>
 #endif
+#ifdef CONFIG_XCB
+#include <X11/Xlib-xcb.h>
+#endif
 
 #ifdef CONFIG_I18N
 #include <locale.h>
@@ -68,6 +75,14 @@ const long Sticky = long(0xFFFFFFFF);
 char const* ApplicationName = "icesh";
 static Display *display;
 static Window root;
+static unsigned long roundTrips;
+
+// Count a request which waits for the reply of the X server.
+template<class T>
+static T roundTrip(T result) {
+    ++roundTrips;
+    return result;
+}
 
 static const char* get_help_text() {
     return _("For help please consult the man page icesh(1).\n");
@@ -128,7 +143,7 @@ public:
     const char* name() const { return fName; }
     operator Atom() {
         if (fAtom == None && fName) {
-            fAtom = XInternAtom(display, fName, fExists);
+            fAtom = roundTrip(XInternAtom(display, fName, fExists));
             if (fExists == false) {
                 insert();
             }
@@ -140,7 +155,7 @@ public:
         if (lookup(atom, &pos)) {
             return fAtoms[pos]->fName;
         } else {
-            char* name = XGetAtomName(display, atom);
+            char* name = roundTrip(XGetAtomName(display, atom));
             NAtom* ptr = new NAtom(name);
             ptr->fAtom = atom;
             ptr->fDynamic = true;
@@ -325,13 +340,14 @@ public:
 
     bool load_rand() {
 #ifdef CONFIG_XRANDR
-        XRRScreenResources *rr = XRRGetScreenResources(display, root);
+        XRRScreenResources *rr =
+            roundTrip(XRRGetScreenResources(display, root));
         if (rr && 0 < rr->ncrtc) {
             const int screens = rr->ncrtc;
             fInfo.clear();
             for (int k = 0; k < screens; ++k) {
                 RRCrtc crt = rr->crtcs[k];
-                XRRCrtcInfo *ci = XRRGetCrtcInfo(display, rr, crt);
+                XRRCrtcInfo *ci = roundTrip(XRRGetCrtcInfo(display, rr, crt));
                 fInfo.push_back(YScreen(k, ci->x, ci->y, ci->width, ci->height));
                 XRRFreeCrtcInfo(ci);
             }
@@ -344,12 +360,12 @@ public:
     bool load_xine() {
 #ifdef XINERAMA
         int i;
-        if (XineramaQueryExtension(display, &i, &i) &&
-            XineramaIsActive(display))
+        if (roundTrip(XineramaQueryExtension(display, &i, &i)) &&
+            roundTrip(XineramaIsActive(display)))
         {
             int screens = 0;
             xsmart<XineramaScreenInfo> xine(
-                   XineramaQueryScreens(display, &screens));
+                   roundTrip(XineramaQueryScreens(display, &screens)));
             if (xine) {
                 fInfo.clear();
                 for (int k = 0; k < screens; ++k) {
@@ -444,6 +460,7 @@ public:
         if (type) fType = type;
         if (leng) fLength = leng;
         if (fWindow && fProp && fLength) {
+            ++roundTrips;
             fStatus = XGetWindowProperty(display, fWindow, fProp, 0L,
                                          fLength, False, fType, &type,
                                          &fFormat, &fCount, &fAfter, &fData);
@@ -555,6 +572,15 @@ public:
     }
 };
 
+static long netStateFlag(Atom atom) {
+    for (int k = 0; k < netStateAtomCount; ++k) {
+        if (atom == netStateAtoms[k].atom) {
+            return netStateAtoms[k].flag;
+        }
+    }
+    return 0L;
+}
+
 class YNetState : public YProperty {
     long fState;
 public:
@@ -563,13 +589,7 @@ public:
         fState(0)
     {
         for (int i = 0; i < count(); ++i) {
-            Atom atom = data<long>(i);
-            for (int k = 0; k < netStateAtomCount; ++k) {
-                if (atom == netStateAtoms[k].atom) {
-                    fState |= netStateAtoms[k].flag;
-                    break;
-                }
-            }
+            fState |= netStateFlag(data<long>(i));
         }
     }
     long state() const { return fState; }
@@ -703,7 +723,7 @@ public:
         fList(nullptr), fProp(property), fCount(0), fStatus(False)
     {
         XTextProperty text;
-        if (XGetTextProperty(display, window, &text, fProp)) {
+        if (roundTrip(XGetTextProperty(display, window, &text, fProp))) {
             if (kind == YEmby) {
                 int xmb = XmbTextPropertyToTextList(display, &text,
                                                     &fList, &fCount);
@@ -814,7 +834,7 @@ static void setWindowGravity(Window window, long gravity) {
 
 static int getWindowGravity(Window window) {
     XWindowAttributes attr = {};
-    XGetWindowAttributes(display, window, &attr);
+    roundTrip(XGetWindowAttributes(display, window, &attr));
     return attr.win_gravity;
 }
 
@@ -827,14 +847,14 @@ static void setBitGravity(Window window, long gravity) {
 
 static int getBitGravity(Window window) {
     XWindowAttributes attr = {};
-    XGetWindowAttributes(display, window, &attr);
+    roundTrip(XGetWindowAttributes(display, window, &attr));
     return attr.bit_gravity;
 }
 
 static void setNormalGravity(Window window, long gravity) {
     XSizeHints normal;
     long supplied;
-    if (XGetWMNormalHints(display, window, &normal, &supplied)) {
+    if (roundTrip(XGetWMNormalHints(display, window, &normal, &supplied))) {
         if (inrange(gravity, 1L, 10L)) {
             normal.win_gravity = int(gravity);
             normal.flags |= PWinGravity;
@@ -853,7 +873,7 @@ static int getNormalGravity(Window window) {
     int gravity = NorthWestGravity;
     XSizeHints normal;
     long supplied;
-    if (XGetWMNormalHints(display, window, &normal, &supplied)) {
+    if (roundTrip(XGetWMNormalHints(display, window, &normal, &supplied))) {
         if (hasbit(normal.flags, PWinGravity)) {
             gravity = normal.win_gravity;
         }
@@ -861,6 +881,210 @@ static int getNormalGravity(Window window) {
     return gravity;
 }
 
+/*
+ * Query many windows at once. With XCB all requests are sent
+ * before the first reply is awaited, which costs one round trip
+ * for the whole set. Without XCB each window is queried in turn.
+ */
+class YPropertyBatch {
+public:
+    YPropertyBatch(const vector<Window>& windows, Atom property,
+                   Atom type, unsigned length = 1);
+
+    bool have(unsigned index) const { return fCounts[index] > 0; }
+    unsigned count(unsigned index) const { return fCounts[index]; }
+    long value(unsigned index, unsigned k = 0) const {
+        return k < fCounts[index] ? fValues[index * fLength + k] : 0L;
+    }
+
+private:
+    unsigned fLength;
+    vector<long> fValues;
+    vector<unsigned> fCounts;
+};
+
+YPropertyBatch::YPropertyBatch(const vector<Window>& windows, Atom property,
+                               Atom type, unsigned length):
+    fLength(length),
+    fValues(windows.size() * length, 0L),
+    fCounts(windows.size(), 0U)
+{
+    const unsigned n = unsigned(windows.size());
+#ifdef CONFIG_XCB
+    xcb_connection_t* conn = XGetXCBConnection(display);
+    vector<xcb_get_property_cookie_t> cookies(n);
+    for (unsigned i = 0; i < n; ++i) {
+        cookies[i] = xcb_get_property(conn, 0, xcb_window_t(windows[i]),
+                                      xcb_atom_t(property), xcb_atom_t(type),
+                                      0, length);
+    }
+    if (n)
+        ++roundTrips;
+    for (unsigned i = 0; i < n; ++i) {
+        xcb_generic_error_t* error = nullptr;
+        xcb_get_property_reply_t* reply =
+            xcb_get_property_reply(conn, cookies[i], &error);
+        if (reply && reply->format == 32) {
+            const uint32_t* data =
+                static_cast<const uint32_t *>(xcb_get_property_value(reply));
+            unsigned num = min(unsigned(reply->value_len), length);
+            for (unsigned k = 0; k < num; ++k)
+                fValues[i * length + k] = long(data[k]);
+            fCounts[i] = num;
+        }
+        free(reply);
+        free(error);
+    }
+#else
+    for (unsigned i = 0; i < n; ++i) {
+        YProperty prop(windows[i], property, type, length);
+        if (prop && prop.format() == 32) {
+            unsigned num = min(unsigned(prop.count()), length);
+            for (unsigned k = 0; k < num; ++k)
+                fValues[i * length + k] = prop.data<long>(k);
+            fCounts[i] = num;
+        }
+    }
+#endif
+}
+
+// Query a text property, which has format 8, of many windows at once.
+class YStringBatch {
+public:
+    YStringBatch(const vector<Window>& windows, Atom property,
+                 Atom type = XA_STRING);
+
+    // The property text, or null if the window has none.
+    const char* value(unsigned index) const {
+        return fOffsets[index] < 0 ? nullptr : &fText[fOffsets[index]];
+    }
+    // The number of bytes of the text, not counting the final null.
+    unsigned length(unsigned index) const { return fLengths[index]; }
+
+private:
+    vector<char> fText;
+    vector<int> fOffsets;
+    vector<unsigned> fLengths;
+
+    void add(unsigned index, const char* text, unsigned length);
+};
+
+YStringBatch::YStringBatch(const vector<Window>& windows, Atom property,
+                           Atom type):
+    fOffsets(windows.size(), -1),
+    fLengths(windows.size(), 0U)
+{
+    const unsigned n = unsigned(windows.size());
+#ifdef CONFIG_XCB
+    xcb_connection_t* conn = XGetXCBConnection(display);
+    vector<xcb_get_property_cookie_t> cookies(n);
+    for (unsigned i = 0; i < n; ++i) {
+        cookies[i] = xcb_get_property(conn, 0, xcb_window_t(windows[i]),
+                                      xcb_atom_t(property), xcb_atom_t(type),
+                                      0, BUFSIZ);
+    }
+    if (n)
+        ++roundTrips;
+    for (unsigned i = 0; i < n; ++i) {
+        xcb_generic_error_t* error = nullptr;
+        xcb_get_property_reply_t* reply =
+            xcb_get_property_reply(conn, cookies[i], &error);
+        if (reply && reply->format == 8 && reply->type == type) {
+            add(i, static_cast<const char *>(xcb_get_property_value(reply)),
+                unsigned(xcb_get_property_value_length(reply)));
+        }
+        free(reply);
+        free(error);
+    }
+#else
+    for (unsigned i = 0; i < n; ++i) {
+        YProperty prop(windows[i], property, type, BUFSIZ);
+        if (prop && prop.format() == 8)
+            add(i, prop.data<char>(), unsigned(prop.count()));
+    }
+#endif
+}
+
+void YStringBatch::add(unsigned index, const char* text, unsigned length) {
+    fOffsets[index] = int(fText.size());
+    fLengths[index] = length;
+    fText.insert(fText.end(), text, text + length);
+    fText.push_back('\0');
+}
+
+// The map state of each window, or -1 if it has gone.
+static void getMapStates(const vector<Window>& windows, vector<int>& states) {
+    const unsigned n = unsigned(windows.size());
+    states.assign(n, -1);
+#ifdef CONFIG_XCB
+    xcb_connection_t* conn = XGetXCBConnection(display);
+    vector<xcb_get_window_attributes_cookie_t> cookies(n);
+    for (unsigned i = 0; i < n; ++i) {
+        cookies[i] = xcb_get_window_attributes(conn, xcb_window_t(windows[i]));
+    }
+    if (n)
+        ++roundTrips;
+    for (unsigned i = 0; i < n; ++i) {
+        xcb_generic_error_t* error = nullptr;
+        xcb_get_window_attributes_reply_t* reply =
+            xcb_get_window_attributes_reply(conn, cookies[i], &error);
+        if (reply)
+            states[i] = reply->map_state;
+        free(reply);
+        free(error);
+    }
+#else
+    for (unsigned i = 0; i < n; ++i) {
+        XWindowAttributes attr = {};
+        ++roundTrips;
+        if (XGetWindowAttributes(display, windows[i], &attr))
+            states[i] = attr.map_state;
+    }
+#endif
+}
+
+// The root geometry of each window. Gone windows get an empty rectangle.
+static void getGeometries(const vector<Window>& windows, vector<YRect>& rects) {
+    const unsigned n = unsigned(windows.size());
+    rects.assign(n, YRect());
+#ifdef CONFIG_XCB
+    xcb_connection_t* conn = XGetXCBConnection(display);
+    vector<xcb_get_geometry_cookie_t> geometry(n);
+    vector<xcb_translate_coordinates_cookie_t> origin(n);
+    for (unsigned i = 0; i < n; ++i) {
+        xcb_window_t window = xcb_window_t(windows[i]);
+        geometry[i] = xcb_get_geometry(conn, window);
+        origin[i] = xcb_translate_coordinates(conn, window,
+                                              xcb_window_t(root), 0, 0);
+    }
+    if (n)
+        ++roundTrips;
+    for (unsigned i = 0; i < n; ++i) {
+        xcb_generic_error_t* error = nullptr;
+        xcb_get_geometry_reply_t* geo =
+            xcb_get_geometry_reply(conn, geometry[i], &error);
+        free(error);
+        error = nullptr;
+        xcb_translate_coordinates_reply_t* pos =
+            xcb_translate_coordinates_reply(conn, origin[i], &error);
+        free(error);
+        if (geo && pos) {
+            rects[i] = YRect(pos->dst_x - geo->border_width,
+                             pos->dst_y - geo->border_width,
+                             geo->width, geo->height);
+        }
+        free(geo);
+        free(pos);
+    }
+#else
+    for (unsigned i = 0; i < n; ++i) {
+        int x, y, w, h;
+        if (getGeometry(windows[i], x, y, w, h))
+            rects[i] = YRect(x, y, w, h);
+    }
+#endif
+}
+
 class YWindowTree;
 
 class YTreeLeaf {
@@ -915,6 +1139,7 @@ public:
             Window rootw;
             Window* data;
             unsigned num;
+            ++roundTrips;
             if (XQueryTree(display, window, &rootw, &fParent, &data, &num)) {
                 copy(data, data + num, back_inserter(fChildren));
                 XFree(data);
@@ -951,12 +1176,12 @@ public:
     }
 
     void filterByMapState(int state) {
+        vector<int> states;
+        getMapStates(fChildren, states);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            XWindowAttributes attr = {};
-            if (XGetWindowAttributes(display, client, &attr)
-                && attr.map_state == state) {
-                keep.push_back(client);
+        for (unsigned i = 0; i < states.size(); ++i) {
+            if (states[i] == state) {
+                keep.push_back(fChildren[i]);
             }
         }
         fChildren = keep;
@@ -979,11 +1204,12 @@ public:
     }
 
     void filterByWorkspace(long workspace, bool inverse = false) {
+        YPropertyBatch desktops(fChildren, ATOM_NET_WM_DESKTOP, XA_CARDINAL);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            long ws = getWorkspace(client);
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            long ws = desktops.value(i);
             if ((ws == workspace || hasbits(ws, Sticky)) != inverse) {
-                keep.push_back(client);
+                keep.push_back(fChildren[i]);
             }
         }
         fChildren = keep;
@@ -991,15 +1217,13 @@ public:
 
     void filterByScreen() {
         if (fConfine.confining()) {
+            vector<YRect> rects;
+            getGeometries(fChildren, rects);
+            YRect s(fConfine[fConfine.screen()]);
             vector<Window> keep;
-            for (YTreeIter client(*this); client; ++client) {
-                int x, y, w, h;
-                if (getGeometry(client, x, y, w, h)) {
-                    YRect r(x, y, w, h);
-                    YRect s(fConfine[fConfine.screen()]);
-                    if (s.overlap(r)) {
-                        keep.push_back(client);
-                    }
+            for (unsigned i = 0; i < rects.size(); ++i) {
+                if (s.overlap(rects[i])) {
+                    keep.push_back(fChildren[i]);
                 }
             }
             fChildren = keep;
@@ -1007,11 +1231,11 @@ public:
     }
 
     void filterByLayer(long layer, bool inverse) {
+        YPropertyBatch layers(fChildren, ATOM_WIN_LAYER, XA_CARDINAL);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            YCardinal prop(client, ATOM_WIN_LAYER);
-            if (prop && ((*prop == layer) != inverse)) {
-                keep.push_back(client);
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            if (layers.have(i) && ((layers.value(i) == layer) != inverse)) {
+                keep.push_back(fChildren[i]);
             }
         }
         fChildren = keep;
@@ -1086,22 +1310,28 @@ public:
     }
 
     void filterByRole(char* role, bool inverse) {
+        YStringBatch roles(fChildren, ATOM_WM_WINDOW_ROLE);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            if ((client->wmRole() == role) != inverse) {
-                keep.push_back(client);
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            const char* value = roles.value(i);
+            if ((value && !strcmp(value, role)) != inverse) {
+                keep.push_back(fChildren[i]);
             }
         }
         fChildren = keep;
     }
 
     void filterByNetState(long state, bool inverse, bool anybit) {
+        YPropertyBatch states(fChildren, ATOM_NET_WM_STATE, XA_ATOM, 32);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            YNetState prop(client);
-            bool test(anybit ? hasbit(*prop, state) : hasbits(*prop, state));
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            long flags = 0;
+            for (unsigned k = 0; k < states.count(i); ++k) {
+                flags |= netStateFlag(states.value(i, k));
+            }
+            bool test(anybit ? hasbit(flags, state) : hasbits(flags, state));
             if (test != inverse) {
-                keep.push_back(client);
+                keep.push_back(fChildren[i]);
             }
         }
         fChildren = keep;
@@ -1119,11 +1349,11 @@ public:
     }
 
     void filterByPid(long pid) {
+        YPropertyBatch pids(fChildren, ATOM_NET_WM_PID, XA_CARDINAL);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            YCardinal prop(client, ATOM_NET_WM_PID);
-            if (prop && *prop == pid) {
-                keep.push_back(client);
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            if (pids.have(i) && pids.value(i) == pid) {
+                keep.push_back(fChildren[i]);
             }
         }
         fChildren = keep;
@@ -1131,13 +1361,14 @@ public:
 
     void filterByMachine(const char* machine) {
         size_t len = strlen(machine);
+        YStringBatch machines(fChildren, XA_WM_CLIENT_MACHINE);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            YStringProperty mac(client, XA_WM_CLIENT_MACHINE);
-            if (mac && 0 == strncmp(&mac, machine, len) &&
-                        (mac[len] == 0 || mac[len] == '.'))
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            const char* mac = machines.value(i);
+            if (mac && 0 == strncmp(mac, machine, len) &&
+                       (mac[len] == 0 || mac[len] == '.'))
             {
-                keep.push_back(client);
+                keep.push_back(fChildren[i]);
             }
         }
         fChildren = keep;
@@ -1151,11 +1382,13 @@ public:
         len -= tail;
         name[len] = '\0';
 
+        YStringBatch netNames(fChildren, ATOM_NET_WM_NAME, ATOM_UTF8_STRING);
+        YStringBatch wmNames(fChildren, XA_WM_NAME);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            asmart<char> title(newstr(&client->netName()));
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            const char* title = netNames.value(i);
             if (isEmpty(title))
-                title = newstr(&client->wmName());
+                title = wmNames.value(i);
             if (nonempty(title)) {
                 const char* find = strstr(title, name);
                 if (find) {
@@ -1163,7 +1396,7 @@ public:
                         continue;
                     if (tail && len != strlen(find))
                         continue;
-                    keep.push_back(client);
+                    keep.push_back(fChildren[i]);
                 }
             }
         }
@@ -1171,30 +1404,32 @@ public:
     }
 
     void filterByClass(const char* wmname, const char* wmclass) {
+        YStringBatch classes(fChildren, XA_WM_CLASS);
         vector<Window> keep;
-        for (YTreeIter client(*this); client; ++client) {
-            Window window = client;
-            XClassHint hint;
-            if (XGetClassHint(display, window, &hint)) {
+        for (unsigned i = 0; i < fChildren.size(); ++i) {
+            Window window = fChildren[i];
+            // WM_CLASS holds the instance and the class, each null ended.
+            const char* res_name = classes.value(i);
+            if (res_name) {
+                size_t len = strlen(res_name);
+                const char* res_class = len < classes.length(i)
+                                      ? res_name + len + 1 : "";
                 if (wmclass) {
-                    if (strcmp(hint.res_name, wmname) ||
-                        strcmp(hint.res_class, wmclass))
+                    if (strcmp(res_name, wmname) ||
+                        strcmp(res_class, wmclass))
                         window = None;
                 }
                 else if (wmname) {
-                    if (strcmp(hint.res_name, wmname) &&
-                        strcmp(hint.res_class, wmname))
+                    if (strcmp(res_name, wmname) &&
+                        strcmp(res_class, wmname))
                         window = None;
                 }
 
                 if (window) {
                     MSG(("selected window 0x%lx: `%s.%s'", window,
-                         hint.res_name, hint.res_class));
+                         res_name, res_class));
                     keep.push_back(window);
                 }
-
-                XFree(hint.res_name);
-                XFree(hint.res_class);
             }
         }
         fChildren = keep;
@@ -1281,7 +1516,9 @@ class IceSh {
 public:
     IceSh(int argc, char **argv);
     ~IceSh();
-    operator int() const { return rc ? rc : windowList ? 0 : 1; }
+    operator int() const {
+        return rc ? rc : windowList || serving ? 0 : 1;
+    }
 
 private:
     int rc;
@@ -1292,6 +1529,10 @@ private:
     bool quietude;
     bool selecting;
     bool filtering;
+    bool statistics;
+    bool serving;
+    timeval started;
+    unsigned long firstRequest;
 
     YWindowTree windowList;
 
@@ -1364,13 +1605,19 @@ private:
     bool check(const struct SymbolTable& symtab, long code, const char* str);
     unsigned count() const;
     void xerror(XErrorEvent* evt);
+    void report();
+    int command(char* line);
+    int batch(FILE* input, int output);
+    void server(const char* path);
 
     const char* atomName(Atom atom) {
         return NAtom::lookup(atom);
     }
     static int xerrors(Display* dpy, XErrorEvent* evt);
     static void catcher(int);
+    static void stopper(int);
     static bool running;
+    static bool stopping;
     static IceSh* singleton;
 };
 
@@ -1642,7 +1889,7 @@ static Window getGroupLeader(Window window) {
     if (prop) {
         lead = prop.data()[0];
     } else {
-        XWMHints* h = XGetWMHints(display, window);
+        XWMHints* h = roundTrip(XGetWMHints(display, window));
         if (h) {
             if (h->flags & WindowGroupHint) {
                 lead = h->window_group;
@@ -1655,12 +1902,12 @@ static Window getGroupLeader(Window window) {
 
 static bool getGeometry(Window window, int& x, int& y, int& width, int& height) {
     XWindowAttributes a = {};
-    bool got = XGetWindowAttributes(display, window, &a);
+    bool got = roundTrip(XGetWindowAttributes(display, window, &a));
     if (got) {
         x = a.x, y = a.y, width = a.width, height = a.height;
         while (window != root
             && (window = getParent(window)) != None
-            && XGetWindowAttributes(display, window, &a))
+            && roundTrip(XGetWindowAttributes(display, window, &a)))
         {
             x += a.x;
             y += a.y;
@@ -1699,12 +1946,21 @@ static void extArea(Window window, int& x, int& y, int& w, int& h) {
 }
 
 bool IceSh::running;
+bool IceSh::stopping;
 
+// Stop the current command which loops until interrupted.
 void IceSh::catcher(int)
 {
     running = false;
 }
 
+// Stop the server, but only after the current command.
+void IceSh::stopper(int)
+{
+    running = false;
+    stopping = true;
+}
+
 void IceSh::details(Window w)
 {
     YTreeLeaf leaf(w);
@@ -1768,7 +2024,7 @@ void IceSh::sizeto()
             }
 
             xsmart<XSizeHints> sh(XAllocSizeHints());
-            if (XGetWMNormalHints(display, window, sh, &supplied)) {
+            if (roundTrip(XGetWMNormalHints(display, window, sh, &supplied))) {
                 if (sh->flags & PMaxSize) {
                     w = min<long>(w, sh->max_width);
                     h = min<long>(h, sh->max_height);
@@ -1825,7 +2081,7 @@ void IceSh::sizeby()
             long h = gh + (hper ? hlen * gh / 100L : hlen);
 
             xsmart<XSizeHints> sh(XAllocSizeHints());
-            if (XGetWMNormalHints(display, window, sh, &supplied)) {
+            if (roundTrip(XGetWMNormalHints(display, window, sh, &supplied))) {
                 if (sh->flags & PMaxSize) {
                     w = min<long>(w, sh->max_width);
                     h = min<long>(h, sh->max_height);
@@ -2280,10 +2536,13 @@ bool IceSh::colormaps()
 
     tlog("colormaps");
     running = true;
-    sighandler_t previous = signal(SIGINT, catcher);
-    while (running) {
+    // Keep the previous action, which may be that of the server.
+    struct sigaction sa = {}, previous;
+    sa.sa_handler = catcher;
+    sigaction(SIGINT, &sa, &previous);
+    while (running && stopping == false) {
         int n = 0;
-        Colormap* map = XListInstalledColormaps(display, root, &n);
+        Colormap* map = roundTrip(XListInstalledColormaps(display, root, &n));
         if (n != m || old == nullptr || memcmp(map, old, n * sizeof(Colormap)) || !(++k % 100)) {
             char buf[2000] = "";
             for (int i = 0; i < n; ++i) {
@@ -2301,7 +2560,7 @@ bool IceSh::colormaps()
         usleep(100*1000);
     }
 
-    signal(SIGINT, previous);
+    sigaction(SIGINT, &previous, nullptr);
     return true;
 }
 
@@ -2348,8 +2607,8 @@ void IceSh::click()
             }
             int dx = 0, dy = 0;
             Window child = None;
-            if (XTranslateCoordinates(display, window, window,
-                        int(lx), int(ly), &dx, &dy, &child))
+            if (roundTrip(XTranslateCoordinates(display, window, window,
+                              int(lx), int(ly), &dx, &dy, &child)))
             {
                 XWarpPointer(display, None, window,
                              0, 0, 0, 0, int(lx), int(ly));
@@ -2391,6 +2650,7 @@ bool IceSh::delay()
             getArg();
         }
     }
+    roundTrip(XSync(display, False));
     fsleep(delay);
     return true;
 }
@@ -2413,9 +2673,12 @@ bool IceSh::guiEvents()
         return false;
 
     running = true;
-    sighandler_t previous = signal(SIGINT, catcher);
+    // Keep the previous action, which may be that of the server.
+    struct sigaction sa = {}, previous;
+    sa.sa_handler = catcher;
+    sigaction(SIGINT, &sa, &previous);
     XSelectInput(display, root, PropertyChangeMask);
-    while (running) {
+    while (running && stopping == false) {
         if (XPending(display)) {
             XEvent xev = { 0 };
             XNextEvent(display, &xev);
@@ -2441,7 +2704,7 @@ bool IceSh::guiEvents()
             select(fd + 1, SELECT_TYPE_ARG234 &rfds, nullptr, nullptr, nullptr);
         }
     }
-    signal(SIGINT, previous);
+    sigaction(SIGINT, &previous, nullptr);
     return true;
 }
 
@@ -2458,6 +2721,8 @@ bool IceSh::icewmAction()
         { "suspend",    ICEWM_ACTION_SUSPEND },
         { "winoptions", ICEWM_ACTION_WINOPTIONS },
         { "keys",       ICEWM_ACTION_RELOADKEYS },
+        { "stats",      ICEWM_ACTION_STATISTICS },
+        { "latency",    ICEWM_ACTION_LATENCY },
     };
     for (Symbol sym : sa) {
         if (0 == strcmp(*argp, sym.name)) {
@@ -2569,14 +2834,15 @@ static void setGeometry(Window window, const char* geometry) {
 
     XSizeHints normal;
     long supplied;
-    if (XGetWMNormalHints(display, window, &normal, &supplied) != True)
+    if (roundTrip(XGetWMNormalHints(display, window,
+                                    &normal, &supplied)) != True)
         return;
 
     Window root;
     int x, y;
     unsigned width, height, dummy;
-    if (XGetGeometry(display, window, &root, &x, &y, &width, &height,
-                     &dummy, &dummy) != True)
+    if (roundTrip(XGetGeometry(display, window, &root, &x, &y,
+                               &width, &height, &dummy, &dummy)) != True)
         return;
 
     if (status & XValue) x = geom_x;
@@ -2674,7 +2940,7 @@ static Window getActive() {
     }
     else {
         int revertTo;
-        XGetInputFocus(display, &active, &revertTo);
+        roundTrip(XGetInputFocus(display, &active, &revertTo));
     }
     return active;
 }
@@ -2729,8 +2995,10 @@ static Window pickWindow() {
 
     // this is broken
     XGrabKey(display, escape, 0, root, False, GrabModeAsync, GrabModeAsync);
-    XGrabPointer(display, root, False, ButtonPressMask|ButtonReleaseMask,
-                 GrabModeAsync, GrabModeAsync, root, cursor, CurrentTime);
+    roundTrip(XGrabPointer(display, root, False,
+                           ButtonPressMask|ButtonReleaseMask,
+                           GrabModeAsync, GrabModeAsync, root, cursor,
+                           CurrentTime));
 
     while (running && (None == target || 0 < count)) {
         XEvent event;
@@ -2994,7 +3262,8 @@ void IceSh::showProperty(Window window, Atom atom, const char* prefix) {
     if (atom == XA_WM_NORMAL_HINTS || atom == XA_WM_SIZE_HINTS) {
         XSizeHints h;
         long supplied;
-        if (XGetWMSizeHints(display, window, &h, &supplied, atom) == True) {
+        if (roundTrip(XGetWMSizeHints(display, window, &h,
+                                      &supplied, atom)) == True) {
             const char* name(atomName(atom));
             printf("%s%s", prefix, (char *) name);
             if (h.flags & USPosition) {
@@ -3047,7 +3316,7 @@ void IceSh::showProperty(Window window, Atom atom, const char* prefix) {
     }
 
     if (atom == XA_WM_HINTS) {
-        xsmart<XWMHints> h(XGetWMHints(display, window));
+        xsmart<XWMHints> h(roundTrip(XGetWMHints(display, window)));
         if (h) {
             long f = h->flags;
             const char* name(atomName(atom));
@@ -3179,7 +3448,8 @@ void IceSh::confine(const char* val) {
             Window r, s;
             int x, y, a, b;
             unsigned m;
-            if (XQueryPointer(display, root, &r, &s, &x, &y, &a, &b, &m)) {
+            if (roundTrip(XQueryPointer(display, root, &r, &s,
+                                        &x, &y, &a, &b, &m))) {
                 YRect mouse(x, y, 1, 1);
                 Confine& c = windowList.xine();
                 for (int i = 0; i < c.count(); ++i) {
@@ -3220,7 +3490,7 @@ void IceSh::extendClass()
         vector<XClassHint> classes;
         FOREACH_WINDOW(window) {
             XClassHint h = { nullptr, nullptr };
-            if (XGetClassHint(display, window, &h) == True) {
+            if (roundTrip(XGetClassHint(display, window, &h)) == True) {
                 classes.push_back(h);
             }
         }
@@ -3229,7 +3499,7 @@ void IceSh::extendClass()
         for (YTreeIter window(clients); window; ++window) {
             if (windowList.have(window) == false) {
                 XClassHint h = { nullptr, nullptr };
-                if (XGetClassHint(display, window, &h) == True) {
+                if (roundTrip(XGetClassHint(display, window, &h)) == True) {
                     if (nonempty(h.res_class)) {
                         for (XClassHint c : classes) {
                             if (nonempty(c.res_class)
@@ -3300,17 +3570,234 @@ IceSh::IceSh(int ac, char **av) :
     dpyname(nullptr),
     quietude(false),
     selecting(false),
-    filtering(false)
+    filtering(false),
+    statistics(false),
+    serving(false),
+    started(monotime()),
+    firstRequest(1)
 {
     singleton = this;
     setAtomName(NAtom::lookup);
     try {
         xinit();
+        if (isArg("-batch") || isArg("--batch")) {
+            serving = true;
+            rc = batch(stdin, -1);
+        }
+        else if (isArg("-server") || isArg("--server")) {
+            serving = true;
+            if (haveArg() == false) {
+                msg(_("Action `%s' requires at least %d arguments."),
+                    argp[-1], 1);
+                throw 1;
+            }
+            server(getArg());
+        }
+        else {
+            flags();
+        }
+    }
+    catch (int code) {
+        rc = code;
+    }
+}
+
+// Split a command line into words, which may be quoted.
+static bool splitLine(char* line, vector<char*>& words)
+{
+    char* dest = line;
+    for (char* ptr = line; *ptr; ) {
+        if (isWhiteSpace(*ptr)) {
+            ++ptr;
+            continue;
+        }
+        if (*ptr == '#' && dest == line)
+            break;
+        char* word = dest;
+        while (*ptr && !isWhiteSpace(*ptr)) {
+            if (*ptr == '\'' || *ptr == '"') {
+                char quote = *ptr++;
+                while (*ptr && *ptr != quote)
+                    *dest++ = *ptr++;
+                if (*ptr++ != quote)
+                    return false;
+            }
+            else if (*ptr == '\\' && ptr[1]) {
+                *dest++ = ptr[1];
+                ptr += 2;
+            }
+            else {
+                *dest++ = *ptr++;
+            }
+        }
+        words.push_back(word);
+        if (*ptr)
+            ++ptr;
+        *dest++ = '\0';
+    }
+    return true;
+}
+
+// Run one command line on the open display and return its status.
+int IceSh::command(char* line)
+{
+    vector<char*> words;
+    words.push_back(argv[0]);
+    if (splitLine(line, words) == false) {
+        msg(_("Unbalanced quotes: `%s'"), line);
+        return 1;
+    }
+    if (words.size() == 1)
+        return 0;
+
+    int saveArgc = argc;
+    char** saveArgv = argv;
+    argc = int(words.size());
+    argv = words.data();
+    argp = argv + 1;
+    rc = 0;
+    // Each command is synchronized once, when it is done.
+    XSynchronize(display, False);
+    quietude = selecting = filtering = false;
+    statistics = false;
+    started = monotime();
+    firstRequest = XNextRequest(display);
+    roundTrips = 0;
+    windowList = YWindowTree();
+    ifs.clear();
+    trees.clear();
+
+    try {
         flags();
     }
     catch (int code) {
         rc = code;
     }
+    roundTrip(XSync(display, False));
+    if (statistics) {
+        report();
+        statistics = false;
+    }
+    int status = rc ? rc : windowList ? 0 : 1;
+
+    argc = saveArgc;
+    argv = saveArgv;
+    argp = argv + argc;
+    rc = 0;
+    return status;
+}
+
+// Read command lines until end of input and follow the output of each
+// command by its status. When output is a descriptor, redirect all of
+// it there.
+int IceSh::batch(FILE* input, int output)
+{
+    int result = 0;
+    char* line = nullptr;
+    size_t size = 0;
+    ssize_t len;
+    while ((len = getline(&line, &size, input)) > 0) {
+        if (line[len - 1] == '\n')
+            line[len - 1] = '\0';
+
+        int saveOut = -1, saveErr = -1;
+        if (output >= 0) {
+            fflush(stdout);
+            fflush(stderr);
+            saveOut = dup(1);
+            saveErr = dup(2);
+            dup2(output, 1);
+            dup2(output, 2);
+        }
+        int status = command(line);
+        fflush(stdout);
+        fflush(stderr);
+        clearerr(stdout);
+
+        char buf[32];
+        int n = snprintf(buf, sizeof buf, "exit %d\n", status);
+        if (output >= 0) {
+            dup2(saveOut, 1);
+            dup2(saveErr, 2);
+            close(saveOut);
+            close(saveErr);
+
+            if (write(output, buf, size_t(n)) != n)
+                break;
+        }
+        else {
+            fputs(buf, stdout);
+            fflush(stdout);
+        }
+        if (status)
+            result = status;
+    }
+    free(line);
+    return result;
+}
+
+// Serve command lines from clients on a Unix socket, one at a time.
+void IceSh::server(const char* path)
+{
+    sockaddr_un addr = {};
+    if (strlen(path) >= sizeof addr.sun_path) {
+        msg(_("Socket path too long: `%s'"), path);
+        throw 1;
+    }
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof addr.sun_path - 1);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == -1) {
+        fail("socket");
+        throw 1;
+    }
+    struct stat st;
+    if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+        unlink(path);
+    mode_t mask = umask(077);
+    int bound = bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof addr);
+    umask(mask);
+    if (bound == -1 || listen(sock, 8) == -1) {
+        fail(_("Cannot listen on %s"), path);
+        close(sock);
+        throw 1;
+    }
+
+    // Without SA_RESTART a signal interrupts accept. While a client
+    // is served, an interrupt only ends the command which is running.
+    struct sigaction sa = {}, ca = {}, previousInt, previousTerm;
+    sa.sa_handler = stopper;
+    ca.sa_handler = catcher;
+    sigaction(SIGINT, &sa, &previousInt);
+    sigaction(SIGTERM, &sa, &previousTerm);
+    sighandler_t previousPipe = signal(SIGPIPE, SIG_IGN);
+    stopping = false;
+    while (stopping == false) {
+        int conn = accept(sock, nullptr, nullptr);
+        if (conn == -1) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            fail("accept");
+            rc = 1;
+            break;
+        }
+        FILE* input = fdopen(conn, "r");
+        if (input) {
+            sigaction(SIGINT, &ca, nullptr);
+            batch(input, conn);
+            sigaction(SIGINT, &sa, nullptr);
+            fclose(input);
+        } else {
+            close(conn);
+        }
+    }
+    sigaction(SIGINT, &previousInt, nullptr);
+    sigaction(SIGTERM, &previousTerm, nullptr);
+    signal(SIGPIPE, previousPipe);
+
+    close(sock);
+    unlink(path);
 }
 
 bool IceSh::haveArg()
@@ -3564,6 +4051,13 @@ void IceSh::flag(char* arg)
         selecting = true;
         return;
     }
+    if (isOptArg(arg, "-stats", "")) {
+        // In synchronous mode every request is a round trip, which
+        // would hide the ones that are counted. Sync only when done.
+        XSynchronize(display, False);
+        statistics = true;
+        return;
+    }
     if (isOptArg(arg, "-all", "")) {
         windowList.getClientList();
         MSG(("all windows selected"));
@@ -4490,7 +4984,8 @@ void IceSh::parseAction()
         else if (isAction("properties", 0)) {
             FOREACH_WINDOW(window) {
                 int count = 0;
-                Atom* atoms = XListProperties(display, window, &count);
+                Atom* atoms =
+                    roundTrip(XListProperties(display, window, &count));
                 if (count && atoms) {
                     char buf[32];
                     snprintf(buf, sizeof buf, "0x%07x ", unsigned(window));
@@ -4533,10 +5028,21 @@ void IceSh::parseAction()
     }
 }
 
+void IceSh::report()
+{
+    unsigned long requests = XNextRequest(display) - firstRequest;
+    double millis = 1e3 * toDouble(monotime() - started);
+    fprintf(stderr, _("%lu requests sent, %lu round trips "
+                      "waiting on a reply, %.3f ms\n"),
+           requests, roundTrips, millis);
+}
+
 IceSh::~IceSh()
 {
     if (display) {
-        XSync(display, False);
+        roundTrip(XSync(display, False));
+        if (statistics)
+            report();
         XCloseDisplay(display);
         display = nullptr;
         root = None;
@@ -3,6 +3,7 @@
 #include "intl.h"
 #include "yapp.h"
 #include "ytime.h"
+#include "ytimer.h"
 #include "sysdep.h"
 #include "appnames.h"
 #include "ypointer.h"
@@ -10,6 +11,7 @@
 using namespace ASCII;
 #include "ywordexp.h"
 #include <X11/Xlib.h>
+#include <X11/Xatom.h>
 
 #ifdef CONFIG_EXTERNAL_TRAY
 #define NOTRAY false
@@ -19,7 +21,7 @@ using namespace ASCII;
 
 char const *ApplicationName = ICESMEXE;
 
-class SessionManager: public YApplication {
+class SessionManager: public YApplication, private YTimerListener {
 private:
     char* trim(char *line) {
         size_t len = strlen(line);
@@ -219,6 +221,9 @@ public:
         sound_pid = -1;
         rescue_pid = -1;
         crashtime = zerotime();
+        starttime = monotime();
+        traytime = zerotime();
+        readyDisplay = nullptr;
 
         catchSignal(SIGCHLD);
         catchSignal(SIGTERM);
@@ -300,6 +305,21 @@ public:
         }
     }
 
+    // Start the components which do not depend on each other together.
+    // icewm goes first, because the tray and the startup script wait
+    // for it. Each start is logged with the time since icesm started.
+    void startup() {
+        runWM();
+        if (wm_pid > 0)
+            report(_("%s started after %.3f seconds."), icewmExe);
+        runIcewmbg();
+        if (bg_pid > 0)
+            report(_("%s started after %.3f seconds."), ICEWMBGEXE);
+        runIcesound();
+        if (sound_pid > 0)
+            report(_("%s started after %.3f seconds."), ICESOUNDEXE);
+    }
+
     void runIcewmbg(bool quit = false) {
         const char *args[12] = { ICEWMBGEXE, nullptr, nullptr };
 
@@ -407,10 +427,8 @@ public:
                 free(copy);
             }
             if (wm_pid > 0 && notify == false && startup_phase == 0) {
-                fsleep(1.0);
-                if (kill(wm_pid, 0) == 0) {
-                    notified();
-                }
+                // Without notification, watch for the WM to appear.
+                readyTimer->setTimer(readyPoll, this, true);
             }
         }
     }
@@ -441,10 +459,17 @@ private:
                     if (wm_pid == -1)
                         runWM();
                 }
-                else if (pid == sound_pid)
+                else if (pid == sound_pid) {
                     sound_pid = -1;
+                    if (startup_phase < 2)
+                        report(_("%s exited after %.3f seconds."),
+                               ICESOUNDEXE);
+                }
                 else if (pid == bg_pid) {
                     bg_pid = -1;
+                    if (startup_phase < 2)
+                        report(_("%s exited after %.3f seconds."),
+                               ICEWMBGEXE);
                     checkIcewmbgExitStatus(status);
                 }
                 else if (pid == rescue_pid) {
@@ -640,15 +665,104 @@ private:
         }
     }
 
+    // When icewm is ready icewmtray starts, and when the tray is ready
+    // the startup script runs. icewm and the tray report in by SIGUSR1,
+    // or are seen to own their selections, whichever comes first.
     void notified() {
-        if (++startup_phase == 1)
+        if (++startup_phase == 1) {
+            report(_("%s ready after %.3f seconds."), icewmExe);
             runIcewmtray();
+            if (tray_pid > 0) {
+                report(_("%s started after %.3f seconds."), ICEWMTRAYEXE);
+                traytime = monotime();
+                readyTimer->setTimer(readyPoll, this, true);
+            }
+        }
         else if (startup_phase == 2) {
+            if (readyTimer)
+                readyTimer->stopTimer();
+            if (notrayArg == false)
+                report(_("%s ready after %.3f seconds."), ICEWMTRAYEXE);
+            closeReadyDisplay();
             runScript("startup");
         }
     }
 
+    void report(const char* format, const char* name) {
+        tlog(format, name, toDouble(monotime() - starttime));
+    }
+
+    // Whether the selection prefix with the default screen has an owner.
+    bool selectionOwned(const char* prefix) {
+        if (readyDisplay == nullptr) {
+            readyDisplay = XOpenDisplay(displayArg);
+            if (readyDisplay == nullptr)
+                return false;
+        }
+        char name[64];
+        snprintf(name, sizeof name, "%s%d", prefix,
+                 DefaultScreen(readyDisplay));
+        Atom atom = XInternAtom(readyDisplay, name, False);
+        return XGetSelectionOwner(readyDisplay, atom) != None;
+    }
+
+    // Whether a window manager has claimed the screen.
+    bool wmReady() {
+        if (selectionOwned("WM_S") == false)
+            return false;
+
+        Atom check = XInternAtom(readyDisplay, "_NET_SUPPORTING_WM_CHECK",
+                                 False);
+
+        Atom type = None;
+        int format = 0;
+        unsigned long count = 0, after = 0;
+        unsigned char* data = nullptr;
+        if (XGetWindowProperty(readyDisplay, DefaultRootWindow(readyDisplay),
+                               check, 0L, 1L, False, XA_WINDOW, &type,
+                               &format, &count, &after, &data) == Success
+            && data)
+        {
+            XFree(data);
+        }
+        return type == XA_WINDOW && count == 1;
+    }
+
+    void closeReadyDisplay() {
+        if (readyDisplay) {
+            XCloseDisplay(readyDisplay);
+            readyDisplay = nullptr;
+        }
+    }
+
+    bool handleTimer(YTimer* timer) override {
+        if (startup_phase == 0) {
+            if (wm_pid == -1)
+                return false;
+            if (wmReady() == false &&
+                toDouble(monotime() - starttime) < wmTimeout)
+                return true;
+            notified();
+        }
+        else if (startup_phase == 1) {
+            if (tray_pid == -1 ||
+                selectionOwned("_NET_SYSTEM_TRAY_S") == false)
+            {
+                if (tray_pid > 0 &&
+                    toDouble(monotime() - traytime) < trayTimeout)
+                    return true;
+                tlog(_("%s did not report ready."), ICEWMTRAYEXE);
+            }
+            notified();
+        }
+        return false;
+    }
+
 private:
+    static const long readyPoll = 50;
+    static constexpr double wmTimeout = 10.0;
+    static constexpr double trayTimeout = 10.0;
+
     int startup_phase;
     int bg_pid;
     int wm_pid;
@@ -657,6 +771,10 @@ private:
     int sound_pid;
     int rescue_pid;
     timeval crashtime;
+    timeval starttime;
+    timeval traytime;
+    Display* readyDisplay;
+    lazy<YTimer> readyTimer;
     mstring wmoptions;
     mstring helptext;
 };
@@ -770,9 +888,7 @@ int main(int argc, char **argv) {
 
     xapp.loadEnv("env");
 
-    xapp.runIcewmbg();
-    xapp.runIcesound();
-    xapp.runWM();
+    xapp.startup();
 
     int status = xapp.mainLoop();
 
@@ -943,6 +943,9 @@ void YFrameWindow::startMoveSize(bool doMove, bool byMouse,
 
     movingWindow = doMove;
     sizingWindow = !doMove;
+    sizingPending = false;
+    if (sizingWindow && opaqueResize)
+        client()->syncStart();
 
     statusMoveSize->begin(this);
 
@@ -958,6 +961,11 @@ void YFrameWindow::startMoveSize(bool doMove, bool byMouse,
 }
 
 void YFrameWindow::endMoveSize() {
+    if (sizingWindow) {
+        client()->syncStop();
+        applyPendingResize();
+    }
+
     xapp->releaseEvents();
     statusMoveSize->end();
 
@@ -1071,6 +1079,21 @@ void YFrameWindow::handleButton(const XButtonEvent &button) {
     YWindow::handleButton(button);
 }
 
+// Resize to the latest pointer position, once the client has caught up.
+void YFrameWindow::applyPendingResize() {
+    if (sizingPending && sizingWindow) {
+        sizingPending = false;
+        if (sizingRect.width() != width() || sizingRect.height() != height())
+            client()->syncRequest();
+
+        drawMoveSizeFX(x(), y(), width(), height());
+        setCurrentGeometryOuter(sizingRect);
+        drawMoveSizeFX(x(), y(), width(), height());
+
+        statusMoveSize->setStatus(this);
+    }
+}
+
 void YFrameWindow::handleMotion(const XMotionEvent &motion) {
     if (sizingWindow) {
         int newX = x(), newY = y();
@@ -1078,11 +1101,10 @@ void YFrameWindow::handleMotion(const XMotionEvent &motion) {
 
         handleResizeMouse(motion, newX, newY, newWidth, newHeight);
 
-        drawMoveSizeFX(x(), y(), width(), height());
-        setCurrentGeometryOuter(YRect(newX, newY, newWidth, newHeight));
-        drawMoveSizeFX(x(), y(), width(), height());
-
-        statusMoveSize->setStatus(this);
+        sizingRect = YRect(newX, newY, newWidth, newHeight);
+        sizingPending = true;
+        if (client()->syncWaiting() == false)
+            applyPendingResize();
         return ;
     } else if (movingWindow) {
         int newX = x();
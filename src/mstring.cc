@@ -14,43 +14,51 @@
 #include "base.h"
 #include "ascii.h"
 
-void MStringRef::alloc(size_t len) {
-    fStr = new (malloc(sizeof(MStringData) + len + 1)) MStringData();
-}
-
-void MStringRef::create(const char* str, size_t len) {
-    if (len) {
-        alloc(len);
-        if (str) {
-            strncpy(fStr->fStr, str, len);
-            fStr->fStr[len] = 0;
-        } else {
-            memset(fStr->fStr, 0, len + 1);
-        }
-    } else {
-        fStr = nullptr;
+unsigned long MStringData::fAllocations;
+
+MStringData* MStringData::alloc(size_t len) {
+    void* mem = malloc(sizeof(MStringData) + len + 1);
+    if (mem == nullptr)
+        throw std::bad_alloc();
+    fAllocations++;
+    return new (mem) MStringData();
+}
+
+// Set the length to len and return a buffer for len characters,
+// which is either inline or a new shared buffer, and terminate it.
+char* mstring::alloc(size_t len) {
+    fCount = len;
+    char* buf = fShort;
+    if (!isShort()) {
+        fShared.fData = MStringData::alloc(len);
+        fShared.fData->acquire();
+        fShared.fOffset = 0;
+        buf = fShared.fData->fStr;
     }
+    buf[len] = '\0';
+    return buf;
 }
 
-mstring::mstring(const MStringRef& str, size_t offset, size_t count):
-    fRef(str),
-    fOffset(offset),
+mstring::mstring(const mstring& str, size_t offset, size_t count):
     fCount(count)
 {
-    acquire();
+    if (isShort()) {
+        memcpy(fShort, str.data() + offset, count);
+        fShort[count] = '\0';
+    } else {
+        fShared.fData = str.fShared.fData;
+        fShared.fOffset = str.fShared.fOffset + offset;
+        acquire();
+    }
 }
 
-mstring::mstring(const char* str1, size_t len1, const char* str2, size_t len2):
-    fRef(len1 + len2), fOffset(0), fCount(len1 + len2)
+mstring::mstring(const char* str1, size_t len1, const char* str2, size_t len2)
 {
-    if (fRef) {
-        if (len1)
-            strncpy(fRef->fStr, str1, len1);
-        if (len2)
-            strncpy(fRef->fStr + len1, str2, len2);
-        fRef[fCount] = 0;
-        fRef.acquire();
-    }
+    char* buf = alloc(len1 + len2);
+    if (len1)
+        memcpy(buf, str1, len1);
+    if (len2)
+        memcpy(buf + len1, str2, len2);
 }
 
 mstring::mstring(const char* str):
@@ -58,10 +66,13 @@ mstring::mstring(const char* str):
 {
 }
 
-mstring::mstring(const char* str, size_t len):
-    fRef(str, len), fOffset(0), fCount(len)
-{
-    acquire();
+mstring::mstring(const char* str, size_t len) {
+    char* buf = alloc(len);
+    if (str) {
+        strncpy(buf, str, len);
+    } else {
+        memset(buf, 0, len);
+    }
 }
 
 mstring::mstring(const char *str1, const char *str2):
@@ -73,46 +84,25 @@ mstring::mstring(const char *str1, const char *str2, const char *str3) {
     size_t len1 = str1 ? strlen(str1) : 0;
     size_t len2 = str2 ? strlen(str2) : 0;
     size_t len3 = str3 ? strlen(str3) : 0;
-    fOffset = 0;
-    fCount = len1 + len2 + len3;
-    fRef.alloc(fCount);
-    if (len1) memcpy(fRef->fStr, str1, len1);
-    if (len2) memcpy(fRef->fStr + len1, str2, len2);
-    if (len3) memcpy(fRef->fStr + len1 + len2, str3, len3);
-    fRef[fCount] = 0;
-    fRef.acquire();
+    char* buf = alloc(len1 + len2 + len3);
+    if (len1) memcpy(buf, str1, len1);
+    if (len2) memcpy(buf + len1, str2, len2);
+    if (len3) memcpy(buf + len1 + len2, str3, len3);
 }
 
 mstring::mstring(const char *str1, const char *str2, const char *str3,
                  const char *str4, const char *str5, const char *str6)
 {
-    const int count = 6;
-    const char* string[count] = {str1, str2, str3, str4, str5, str6};
-    size_t length[count];
-    size_t total = 0;
-    for (int i = 0; i < count; ++i) {
-        total += length[i] = (string[i] ? strlen(string[i]) : 0);
-    }
-    fOffset = 0;
-    fCount = total;
-    fRef.alloc(fCount);
-    size_t build = 0;
-    for (int i = 0; i < count; ++i) {
-        if (length[i]) {
-            memcpy(fRef->fStr + build, string[i], length[i]);
-            build += length[i];
-        }
-    }
-    fRef[fCount] = 0;
-    fRef.acquire();
+    MStringBuilder builder;
+    builder << str1 << str2 << str3 << str4 << str5 << str6;
+    fCount = 0;
+    *this = builder.str();
 }
 
-mstring::mstring(long n):
-    fRef(size_t(23)), fOffset(0), fCount(0)
-{
-    snprintf(fRef->fStr, 23, "%ld", n);
-    fCount = strlen(fRef->fStr);
-    fRef.acquire();
+mstring::mstring(long n) {
+    char buf[24];
+    size_t len = size_t(snprintf(buf, sizeof buf, "%ld", n));
+    memcpy(alloc(len), buf, len);
 }
 
 mstring mstring::operator+(const mstring& rv) const {
@@ -125,25 +115,24 @@ void mstring::operator+=(const mstring& rv) {
 }
 
 mstring& mstring::operator=(const mstring& rv) {
-    if (fRef != rv.fRef) {
+    if (this != &rv) {
+        rv.acquire();
         release();
-        fRef = rv.fRef;
-        acquire();
+        memcpy(fShort, rv.fShort, sizeof fShort);
+        fCount = rv.fCount;
     }
-    fOffset = rv.fOffset;
-    fCount = rv.fCount;
     return *this;
 }
 
 mstring mstring::substring(size_t pos) const {
     return pos <= length()
-        ? mstring(fRef, fOffset + pos, fCount - pos)
+        ? mstring(*this, pos, fCount - pos)
         : null;
 }
 
 mstring mstring::substring(size_t pos, size_t len) const {
     return pos <= length()
-        ? mstring(fRef, fOffset + pos, min(len, fCount - pos))
+        ? mstring(*this, pos, min(len, fCount - pos))
         : null;
 }
 
@@ -278,17 +267,19 @@ mstring mstring::searchAndReplaceAll(const mstring& s, const mstring& r) const {
 }
 
 mstring mstring::lower() const {
-    mstring mstr(nullptr, fCount);
+    mstring mstr;
+    char* buf = mstr.alloc(fCount);
     for (size_t i = 0; i < fCount; ++i) {
-        mstr.fRef[i] = ASCII::toLower(data()[i]);
+        buf[i] = ASCII::toLower(data()[i]);
     }
     return mstr;
 }
 
 mstring mstring::upper() const {
-    mstring mstr(nullptr, fCount);
+    mstring mstr;
+    char* buf = mstr.alloc(fCount);
     for (size_t i = 0; i < fCount; ++i) {
-        mstr.fRef[i] = ASCII::toUpper(data()[i]);
+        buf[i] = ASCII::toUpper(data()[i]);
     }
     return mstr;
 }
@@ -306,23 +297,65 @@ mstring mstring::trim() const {
 
 const char* mstring::c_str()
 {
-    if (isEmpty()) {
-        return "";
+    if (isShort()) {
+        return fShort;
     }
     else if (data()[fCount]) {
-        if (fRef->fRefCount == 1) {
-            fRef[fOffset + fCount] = '\0';
+        if (fShared.fData->fRefCount == 1) {
+            fShared.fData->fStr[fShared.fOffset + fCount] = '\0';
         } else {
+            MStringData* shared = fShared.fData;
             const char* str = data();
-            fRef.release();
-            fRef.create(str, fCount);
-            fRef.acquire();
-            fOffset = 0;
+            memcpy(alloc(fCount), str, fCount);
+            shared->release();
         }
     }
     return data();
 }
 
+char* MStringBuilder::join(char* buf) const {
+    for (int i = 0; i < fParts; ++i) {
+        memcpy(buf, fPart[i], fSize[i]);
+        buf += fSize[i];
+    }
+    return buf;
+}
+
+mstring MStringBuilder::str() const {
+    mstring result;
+    join(result.alloc(fLength));
+    return result;
+}
+
+const char* MStringBuilder::c_str() {
+    if (fLength < sizeof fScratch) {
+        *join(fScratch) = '\0';
+        return fScratch;
+    }
+    fHead = str();
+    fParts = 1;
+    fPart[0] = fHead.data();
+    fSize[0] = fHead.length();
+    return fHead.c_str();
+}
+
+MStringBuilder& MStringBuilder::add(const char* part, size_t len) {
+    if (len) {
+        if (fParts == fMaxParts) {
+            // Join the parts so far into the first part.
+            fHead = str();
+            fParts = 1;
+            fPart[0] = fHead.data();
+            fSize[0] = fHead.length();
+        }
+        fPart[fParts] = part;
+        fSize[fParts] = len;
+        fParts++;
+        fLength += len;
+    }
+    return *this;
+}
+
 mstring mstring::match(const char* regex, const char* flags) const {
     int compFlags = REG_EXTENDED;
     int execFlags = 0;
@@ -7,6 +7,7 @@
 
 #include "ref.h"
 #include <stdlib.h>
+#include <string.h>
 
 /*
  * A reference counted string buffer of arbitrary but fixed size.
@@ -15,53 +16,54 @@ class MStringData {
 public:
     MStringData() : fRefCount(0) {}
 
+    static MStringData* alloc(size_t len);
+    void acquire() { fRefCount++; }
+    void release() { if (fRefCount-- == 1) free(this); }
+
+    // The number of buffers allocated so far.
+    static unsigned long allocations() { return fAllocations; }
+
     int fRefCount;
     char fStr[];
-};
-
-class MStringRef {
-public:
-    MStringRef(): fStr(nullptr) {}
-    explicit MStringRef(MStringData* data): fStr(data) {}
-    explicit MStringRef(size_t len) { alloc(len); }
-    MStringRef(const char* str, size_t len) { create(str, len); }
-
-    void alloc(size_t len);
-    void create(const char* str, size_t len);
-    operator bool() const { return fStr; }
-    MStringData* operator->() const { return fStr; }
-    bool operator!=(const MStringRef& r) const { return fStr != r.fStr; }
-    char& operator[](size_t index) const { return fStr->fStr[index]; }
-    void operator=(MStringData* data) { fStr = data; }
-    void acquire() const { fStr->fRefCount++; }
-    void release() const { if (fStr->fRefCount-- == 1) free(fStr); }
 
 private:
-
-    MStringData* fStr;
+    static unsigned long fAllocations;
 };
 
 /*
  * Mutable strings with a reference counted string buffer.
+ * Short strings are stored inline and need no buffer.
  */
 class mstring {
 private:
     friend class MStringArray;
+    friend class MStringBuilder;
     friend mstring operator+(const char* s, const mstring& m);
 
-    MStringRef fRef;
-    size_t fOffset;
+    struct Shared {
+        MStringData* fData;
+        size_t fOffset;
+    };
+    // Strings shorter than sizeof(Shared) are kept in fShort.
+    union {
+        Shared fShared;
+        char fShort[sizeof(Shared)];
+    };
     size_t fCount;
 
-    void acquire() {
-        if (fRef) { fRef.acquire(); }
+    bool isShort() const { return fCount < sizeof(Shared); }
+    void acquire() const {
+        if (!isShort()) { fShared.fData->acquire(); }
     }
-    void release() {
-        if (fRef) { fRef.release(); }
+    void release() const {
+        if (!isShort()) { fShared.fData->release(); }
     }
-    mstring(const MStringRef& str, size_t offset, size_t count);
+    char* alloc(size_t len);
+    mstring(const mstring& str, size_t offset, size_t count);
     mstring(const char* str1, size_t len1, const char* str2, size_t len2);
-    const char* data() const { return &fRef[fOffset]; }
+    const char* data() const {
+        return isShort() ? fShort : fShared.fData->fStr + fShared.fOffset;
+    }
 
 public:
     mstring(const char *str);
@@ -73,14 +75,11 @@ public:
     mstring(const char *str, size_t len);
     explicit mstring(long);
 
-    mstring(null_ref &): fRef(nullptr), fOffset(0), fCount(0) { }
-    mstring():           fRef(nullptr), fOffset(0), fCount(0) { }
+    mstring(null_ref &): fCount(0) { fShort[0] = '\0'; }
+    mstring():           fCount(0) { fShort[0] = '\0'; }
 
-    mstring(const mstring &r):
-        fRef(r.fRef),
-        fOffset(r.fOffset),
-        fCount(r.fCount)
-    {
+    mstring(const mstring &r): fCount(r.fCount) {
+        memcpy(fShort, r.fShort, sizeof fShort);
         acquire();
     }
     ~mstring() {
@@ -88,7 +87,6 @@ public:
     }
 
     size_t length() const { return fCount; }
-    size_t offset() const { return fOffset; }
     bool isEmpty() const { return 0 == fCount; }
     bool nonempty() const { return 0 < fCount; }
 
@@ -148,6 +146,44 @@ inline mstring operator+(const char* s, const mstring& m) {
     return mstring(s) + m;
 }
 
+/*
+ * Concatenate many parts with a single allocation.
+ * The parts must live until the string is built, as in:
+ *     mstring path = MStringBuilder() << dir << "/" << name << ".png";
+ * A temporary which is only passed to a C function, like a path
+ * to probe, can use c_str instead, which needs no allocation when
+ * the result fits in the builder's own buffer.
+ */
+class MStringBuilder {
+public:
+    MStringBuilder() : fParts(0), fLength(0) { }
+
+    MStringBuilder& operator<<(const char* str) {
+        return str ? add(str, strlen(str)) : *this;
+    }
+    MStringBuilder& operator<<(const mstring& str) {
+        return add(str.data(), str.length());
+    }
+    operator mstring() const { return str(); }
+    mstring str() const;
+    const char* c_str();
+
+private:
+    static const int fMaxParts = 16;
+    char fScratch[256];
+    const char* fPart[fMaxParts];
+    size_t fSize[fMaxParts];
+    int fParts;
+    size_t fLength;
+    mstring fHead;
+
+    MStringBuilder& add(const char* part, size_t len);
+    char* join(char* buf) const;
+
+    MStringBuilder(const MStringBuilder&) = delete;
+    void operator=(const MStringBuilder&) = delete;
+};
+
 #endif
 
 // vim: set sw=4 ts=4 et:
@@ -3,6 +3,7 @@
 #include "upath.h"
 #include "base.h"
 #include "udir.h"
+#include "ytime.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <libgen.h>
@@ -256,6 +257,100 @@ static void test_mstring()
     expect(u, "#fffff");
     u = mstring("f#ffffff").match("#f{5}");
     expect(u, "#fffff");
+
+    mstring s15("abcdefghijklmno");
+    mstring s16("abcdefghijklmnop");
+    expect(s15, "abcdefghijklmno");
+    expect(s16, "abcdefghijklmnop");
+    expect(s15 + "p", "abcdefghijklmnop");
+    expect(s16.substring(1), "bcdefghijklmnop");
+    expect(s16.substring(3, 4), "defg");
+    u = mstring("0123456789", "0123456789", "0123456789");
+    mstring sub(u.substring(5, 20));
+    expect(sub, "56789012345678901234");
+    assert(sub, strcmp(sub.c_str(), "56789012345678901234") == 0);
+    expect(u, "012345678901234567890123456789");
+    expect(mstring(-1234567890L), "-1234567890");
+    expect(mstring("a", "bb", "ccc", "dddd", "eeeee", "ffffff"),
+           "abbcccddddeeeeeffffff");
+    expect(u.upper(), "012345678901234567890123456789");
+    expect(mstring("ABCDEFGHIJKLMNOPQRST").lower(), "abcdefghijklmnopqrst");
+
+    MStringBuilder builder;
+    mstring cee("c");
+    for (int i = 0; i < 40; ++i) {
+        if (i % 2)
+            builder << "ab";
+        else
+            builder << cee;
+    }
+    u = builder;
+    assert(u, u.length() == 60);
+    assert(u, u.count('c') == 20);
+    u = MStringBuilder() << "dir" << "/" << s16 << ".png";
+    expect(u, "dir/abcdefghijklmnop.png");
+
+    MStringBuilder temp;
+    temp << "dir" << "/" << s16 << ".png";
+    assert("temp", strcmp(temp.c_str(), "dir/abcdefghijklmnop.png") == 0);
+    MStringBuilder large;
+    for (int i = 0; i < 100; ++i)
+        large << s16;
+    assert("large", strlen(large.c_str()) == 1600);
+    assert("large", strncmp(large.c_str(), "abcdefghijklmnopabc", 19) == 0);
+}
+
+// Count buffer allocations and time for typical string work.
+static void test_allocs()
+{
+    strtest tester("allocs");
+
+    const char* names[] = { "xterm", "XTerm", "gimp", "Gimp",
+        "mpv", "feh", "icewm", "IceWM" };
+    const int count = int(sizeof names / sizeof names[0]);
+    const int loops = 100000;
+
+    unsigned long before = MStringData::allocations();
+    timeval start = monotime();
+    size_t total = 0;
+    for (int i = 0; i < loops; ++i) {
+        mstring key(names[i % count], ".", names[(i + 1) % count]);
+        mstring left, right;
+        if (key.split('.', &left, &right))
+            total += left.length() + right.length();
+        total += key.lower().length();
+    }
+    double seconds = toDouble(monotime() - start);
+    unsigned long shortAllocs = MStringData::allocations() - before;
+
+    mstring dir("/usr/share/icons/hicolor/48x48/apps/");
+    before = MStringData::allocations();
+    for (int i = 0; i < loops; ++i) {
+        mstring path = MStringBuilder() << dir << names[i % count]
+                       << "_" << "48" << "x" << "48" << ".png";
+        total += path.length();
+    }
+    unsigned long pathAllocs = MStringData::allocations() - before;
+
+    before = MStringData::allocations();
+    for (int i = 0; i < loops; ++i) {
+        MStringBuilder probe;
+        probe << dir << names[i % count] << "_" << "48" << "x" << "48"
+              << ".png";
+        total += strlen(probe.c_str());
+    }
+    unsigned long probeAllocs = MStringData::allocations() - before;
+
+    printf("%s: %7s: %lu allocations for %d short keys in %.3f s,"
+           " %lu for %d paths, %lu for %d probes (%zu)\n", prog, "allocs",
+           shortAllocs, loops, seconds, pathAllocs, loops,
+           probeAllocs, loops, total);
+
+    // Short keys and their parts are inline; paths allocate once;
+    // probed paths stay in the builder.
+    assert("allocs", shortAllocs == 0);
+    assert("allocs", pathAllocs == unsigned(loops));
+    assert("allocs", probeAllocs == 0);
 }
 
 static void test_upath()
@@ -618,6 +713,7 @@ int main(int argc, char **argv)
     prog = basename(argv[0]);
 
     test_mstring();
+    test_allocs();
     test_expand();
     test_upath();
     test_strlc();
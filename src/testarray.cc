@@ -2,6 +2,7 @@
 #include "mstring.h"
 #include "yarray.h"
 #include "ypointer.h"
+#include "ysymbol.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -388,6 +389,53 @@ static void test_refstr() {
     report(__func__);
 }
 
+static void test_symbol() {
+    watch mark;
+
+    assert(YSymbol().isEmpty());
+    assert(YSymbol(nullptr) == YSymbol());
+    assert(YSymbol("") == YSymbol());
+    assert(!strcmp(YSymbol().c_str(), ""));
+
+    YSymbol xterm("XTerm");
+    assert(xterm.nonempty());
+    assert(xterm == YSymbol("XTerm"));
+    assert(xterm != YSymbol("xterm"));
+    assert(!strcmp(xterm.c_str(), "XTerm"));
+    assert(YSymbol("xterm", ".", "XTerm") == YSymbol("xterm.XTerm"));
+    assert(YSymbol(nullptr, ".", "XTerm") == YSymbol(".XTerm"));
+
+    char buf[24];
+    const int N = 12345;
+    const unsigned count = YSymbol::count();
+    asmart<YSymbol> syms(new YSymbol[N]);
+    for (int i = 0; i < N; ++i) {
+        snprintf(buf, sizeof buf, "sym%d", i);
+        syms[i] = YSymbol(buf);
+    }
+    assert(YSymbol::count() == count + N);
+    for (int i = 0; i < N; ++i) {
+        snprintf(buf, sizeof buf, "sym%d", i);
+        assert(YSymbol(buf) == syms[i]);
+        assert(!strcmp(syms[i].c_str(), buf));
+    }
+    assert(YSymbol::count() == count + N);
+    assert(xterm == YSymbol("XTerm"));
+
+    const unsigned before = YSymbol::count();
+    assert(YSymbol::find("XTerm") == xterm);
+    assert(YSymbol::find("xterm", ".", "XTerm") == YSymbol("xterm.XTerm"));
+    assert(YSymbol::find("no-such-symbol").isEmpty());
+    assert(YSymbol::find("no", "-such-", "symbol").isEmpty());
+    assert(YSymbol::find(nullptr).isEmpty());
+    assert(YSymbol::find(nullptr, nullptr, nullptr).isEmpty());
+    assert(YSymbol::count() == before);
+
+    if (test_time)
+        printf("tested symbols OK (%s)\n\n", mark.report());
+    report(__func__);
+}
+
 static void test_options(int argc, char** argv) {
     for (int i = 1; i < argc; ++i) {
         char* s = argv[i];
@@ -410,6 +458,7 @@ int main(int argc, char** argv) {
     test_str();
     test_mstr();
     test_refstr();
+    test_symbol();
 
     return total != 0;
 }
@@ -0,0 +1,109 @@
+/*
+ * testchurn - measure how fast the window manager maps and unmaps windows.
+ *
+ * Repeatedly creates a batch of toplevel windows, maps them,
+ * waits until the window manager has mapped all of them,
+ * and destroys them again. Reports the number of windows per second.
+ * With --stats it finally asks icewm to log its allocation statistics.
+ */
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+#include "base.h"
+#include "ytime.h"
+#include "wmaction.h"
+
+const char* ApplicationName = "testchurn";
+
+static const char* help_text() {
+    return
+    "  -n, --count=NUM     Create NUM windows in total (default 2000).\n"
+    "  -b, --batch=NUM     Map NUM windows at a time (default 50).\n"
+    "  -s, --stats         Request icewm to log its pool statistics.\n"
+    ;
+}
+
+static void sendStatistics(Display* display, Window root) {
+    XClientMessageEvent xev = {};
+    xev.type = ClientMessage;
+    xev.window = root;
+    xev.message_type = XInternAtom(display, "_ICEWM_ACTION", False);
+    xev.format = 32;
+    xev.data.l[0] = CurrentTime;
+    xev.data.l[1] = ICEWM_ACTION_STATISTICS;
+    XSendEvent(display, root, False, SubstructureNotifyMask,
+               reinterpret_cast<XEvent *>(&xev));
+    XSync(display, False);
+}
+
+int main(int argc, char** argv) {
+    int count = 2000;
+    int batch = 50;
+    bool stats = false;
+
+    check_argv(argc, argv, help_text, nullptr);
+    for (char** arg = argv + 1; arg < argv + argc; ++arg) {
+        char* value;
+        if (GetArgument(value, "n", "count", arg, argv + argc))
+            count = max(1, atoi(value));
+        else if (GetArgument(value, "b", "batch", arg, argv + argc))
+            batch = max(1, atoi(value));
+        else if (is_switch(*arg, "s", "stats"))
+            stats = true;
+        else
+            fail("Unknown option: %s", *arg);
+    }
+
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr) {
+        fail("Can't open display: %s. ", XDisplayName(nullptr));
+        return 1;
+    }
+    int screen = DefaultScreen(display);
+    Window root = RootWindow(display, screen);
+    Window* windows = new Window[batch];
+
+    timeval start = monotime();
+    int done = 0;
+    while (done < count) {
+        int n = min(batch, count - done);
+        for (int i = 0; i < n; ++i) {
+            XSetWindowAttributes attr;
+            attr.background_pixel = BlackPixel(display, screen);
+            attr.event_mask = StructureNotifyMask;
+            windows[i] = XCreateWindow(display, root,
+                                       20 * (i % 32), 20 * (i % 24), 64, 64, 0,
+                                       CopyFromParent, InputOutput,
+                                       CopyFromParent,
+                                       CWBackPixel | CWEventMask, &attr);
+            XStoreName(display, windows[i], ApplicationName);
+            XMapWindow(display, windows[i]);
+        }
+        for (int mapped = 0; mapped < n; ) {
+            XEvent xev;
+            XNextEvent(display, &xev);
+            if (xev.type == MapNotify)
+                ++mapped;
+        }
+        for (int i = 0; i < n; ++i)
+            XDestroyWindow(display, windows[i]);
+        XSync(display, True);
+        done += n;
+    }
+    double seconds = toDouble(monotime() - start);
+
+    printf("%d windows in %.3f seconds: %.1f windows/s\n",
+           done, seconds, seconds > 0 ? done / seconds : 0.0);
+
+    if (stats)
+        sendStatistics(display, root);
+
+    delete[] windows;
+    XCloseDisplay(display);
+    return 0;
+}
+
+// vim: set sw=4 ts=4 et:
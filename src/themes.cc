@@ -83,8 +83,8 @@ void ThemesMenu::refresh() {
 
 int ThemesMenu::countThemes(const upath& path) {
     int ret = 0;
-    for (udir dir(path); dir.next(); ) {
-        ret += (path + dir.entry() + "default.theme").isReadable();
+    for (cachedir dir(path); dir.nextDir(); ) {
+        ret += cachedir(path + dir.entry()).hasFile("default.theme");
     }
     return ret;
 }
@@ -120,13 +120,13 @@ void ThemesMenu::findThemes(const upath& path, ObjectMenu* container) {
     auto canUcodeEl = menuFont != null && menuFont->supports(utf32ellipsis);
     memcpy(&subName, canUcodeEl ? "X\xe2\x80\xa6" : "X...", 5);
 
-    for (udir dir(path); dir.next(); ) {
+    for (cachedir dir(path); dir.nextDir(); ) {
         YMenuItem *im(nullptr);
         YMenu* targetMenu = container;
         upath subdir = path + dir.entry();
-        upath defThemePath = subdir + defTheme;
+        cachedir themeDir(subdir);
 
-        if (defThemePath.isReadable()) {
+        if (themeDir.hasFile("default.theme")) {
             mstring relThemeName = dir.entry() + defTheme;
             im = newThemeItem(app, smActionListener, dir.entry(), relThemeName, container);
         }
@@ -177,7 +177,7 @@ void ThemesMenu::findThemes(const upath& path, ObjectMenu* container) {
             }
         }
         if (im) {
-            findThemeAlternatives(app, smActionListener, subdir, dir.entry(),
+            findThemeAlternatives(app, smActionListener, themeDir, dir.entry(),
                                   im, container);
             if (im->isChecked()) {
                 YMenuItem *sub = container->findName(subName);
@@ -193,19 +193,17 @@ void ThemesMenu::findThemes(const upath& path, ObjectMenu* container) {
 void ThemesMenu::findThemeAlternatives(
     IApp *app,
     YSMListener *smActionListener,
-    const upath& path,
+    cachedir& dir,
     const mstring& relName,
     YMenuItem *item,
     ObjectMenu* container)
 {
     mstring defTheme("default.theme");
     mstring extension(".theme");
-    for (udir dir(path); dir.nextExt(extension); ) {
+    for (dir.rewind(); dir.nextExt(extension); ) {
         const mstring entry(dir.entry());
         if (entry != defTheme) {
-            upath altThemePath(path + entry);
-
-            if (altThemePath.isReadable()) {
+            if (dir.isFile()) {
                 YMenu *sub(item->getSubmenu());
 
                 if (sub == nullptr)
@@ -7,6 +7,7 @@
 class YMenu;
 class YSMListener;
 class YActionListener;
+class cachedir;
 
 class DTheme: public DObject {
 public:
@@ -40,7 +41,7 @@ private:
     void findThemeAlternatives(
         IApp *app,
         YSMListener *smActionListener,
-        const upath& path,
+        cachedir& dir,
         const mstring& relName,
         YMenuItem *item,
         ObjectMenu* container);
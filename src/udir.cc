@@ -4,6 +4,7 @@
 #include <dirent.h>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <time.h>
 
 class DirPtr {
 private:
@@ -58,6 +59,22 @@ public:
         }
         return false;
     }
+    // 'd' for a directory, 'f' for a regular file and 'o' otherwise.
+    // The type comes from the entry, unless it is a symbolic link.
+    char type() {
+#if defined(DT_DIR) && defined(DT_REG) && defined(DT_LNK)
+        if (de->d_type && de->d_type != DT_LNK) {
+            return de->d_type == DT_DIR ? 'd' :
+                   de->d_type == DT_REG ? 'f' : 'o';
+        }
+#endif
+        struct stat st;
+        if (fstatat(dirfd(ptr), name(), &st, 0) == 0) {
+            return S_ISDIR(st.st_mode) ? 'd' :
+                   S_ISREG(st.st_mode) ? 'f' : 'o';
+        }
+        return 'o';
+    }
     bool isLink() {
         if (de) {
 #ifdef DT_LNK
@@ -310,5 +327,168 @@ bool sdir::nextExt(const mstring& extension) {
     return false;
 }
 
+class DirList {
+public:
+    DirList() : modified(0), scanned(0), checked(0), used(0), users(0),
+                found(false) { }
+
+    MStringArray names;
+    YArray<char> types;
+    time_t modified;    // the mtime of the directory when it was read
+    time_t scanned;     // when it was read
+    time_t checked;     // when the mtime was last compared
+    unsigned long used; // the value of dirClock when it was last opened
+    int users;
+    bool found;
+
+    void scan(const char* path, time_t now, time_t mtime);
+};
+
+// Enough listings for one pass over all theme directories.
+static const int dirCacheLimit = 256;
+static YAssocArray<DirList*> dirCache;
+static unsigned long dirClock;
+static MStringArray* sortNames;
+
+// Forget the least recently used listing which is not being iterated.
+static void pruneDirCache() {
+    int oldest = -1;
+    for (int i = 0; i < dirCache.getCount(); ++i) {
+        DirList* list = dirCache[i];
+        if (list->users == 0 &&
+            (oldest < 0 || list->used < dirCache[oldest]->used))
+            oldest = i;
+    }
+    if (oldest >= 0) {
+        delete dirCache[oldest].value;
+        dirCache.remove(oldest);
+    }
+}
+
+static int compareIndex(const void* p1, const void* p2) {
+    mstring& s1 = (*sortNames)[*static_cast<const int*>(p1)];
+    mstring& s2 = (*sortNames)[*static_cast<const int*>(p2)];
+    return s1.collate(s2);
+}
+
+void DirList::scan(const char* path, time_t now, time_t mtime) {
+    MStringArray unsorted;
+    YArray<char> kinds;
+    DirPtr dirp(path);
+    found = dirp;
+    while (found && dirp.next()) {
+        unsorted.append(dirp.name());
+        kinds.append(dirp.type());
+    }
+
+    const int count = unsorted.getCount();
+    YArray<int> order;
+    order.setCapacity(count);
+    for (int i = 0; i < count; ++i)
+        order.append(i);
+    if (1 < count) {
+        sortNames = &unsorted;
+        qsort(&*order, count, sizeof(int), compareIndex);
+        sortNames = nullptr;
+    }
+
+    names.clear();
+    types.clear();
+    for (int i = 0; i < count; ++i) {
+        names.append(unsorted[order[i]]);
+        types.append(kinds[order[i]]);
+    }
+    modified = mtime;
+    scanned = now;
+}
+
+// A listing is compared to the directory at most once per second.
+// It is read again when the mtime differs, or when the previous read
+// was in the same second as the last change, which it may have missed.
+// A listing which is being iterated is not replaced until it is free.
+// At most dirCacheLimit listings are kept, if they are not in use.
+cachedir::cachedir(upath path)
+    : fList(nullptr)
+    , fLast(-1)
+{
+    const char* key = path.string();
+    if (dirCache.getCount() >= dirCacheLimit && dirCache.has(key) == false)
+        pruneDirCache();
+    DirList*& list = dirCache[key];
+    if (list == nullptr)
+        list = new DirList();
+    list->used = ++dirClock;
+
+    time_t now = time(nullptr);
+    if (list->checked != now && list->users == 0) {
+        struct stat st;
+        list->checked = now;
+        if (stat(key, &st) || !S_ISDIR(st.st_mode)) {
+            list->names.clear();
+            list->types.clear();
+            list->found = false;
+        }
+        else if (list->found == false ||
+                 list->modified != st.st_mtime ||
+                 list->modified >= list->scanned)
+        {
+            list->scan(key, now, st.st_mtime);
+        }
+    }
+    if (list->found) {
+        fList = list;
+        fList->users++;
+    }
+}
+
+cachedir::~cachedir() {
+    if (fList)
+        fList->users--;
+}
+
+int cachedir::count() const {
+    return fList ? fList->names.getCount() : 0;
+}
+
+mstring& cachedir::entry() const {
+    return fList->names[fLast];
+}
+
+bool cachedir::isDir() const {
+    return inrange(fLast, 0, count() - 1) && fList->types[fLast] == 'd';
+}
+
+bool cachedir::isFile() const {
+    return inrange(fLast, 0, count() - 1) && fList->types[fLast] == 'f';
+}
+
+bool cachedir::next() {
+    return 1 + fLast < count() && ++fLast >= 0;
+}
+
+bool cachedir::nextDir() {
+    while (next()) {
+        if (isDir())
+            return true;
+    }
+    return false;
+}
+
+bool cachedir::nextExt(const mstring& extension) {
+    while (next()) {
+        if (entry().endsWith(extension)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cachedir::hasFile(const char* name) const {
+    for (int i = 0; i < count(); ++i) {
+        if (fList->types[i] == 'f' && fList->names[i] == name)
+            return true;
+    }
+    return false;
+}
 
 // vim: set sw=4 ts=4 et:
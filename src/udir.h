@@ -117,6 +117,36 @@ private:
     int fLast;
 };
 
+class DirList;
+
+// sorted directory with entry types, cached for mstrings.
+// Listings are shared per path and are read again only when
+// the modification time of the directory changes.
+class cachedir {
+public:
+    explicit cachedir(upath path);
+    ~cachedir();
+    mstring& entry() const;
+    operator bool() const { return isOpen() && fLast < count(); }
+
+    bool isOpen() const { return fList != nullptr; }
+    bool isDir() const;
+    bool isFile() const;
+    bool next();
+    bool nextDir();
+    bool nextExt(const mstring& extension);
+    bool hasFile(const char* name) const;
+    void rewind() { fLast = -1; }
+    int count() const;
+
+private:
+    cachedir(const cachedir&);  // unavailable
+    cachedir& operator=(const cachedir&);  // unavailable
+
+    DirList* fList;
+    int fLast;
+};
+
 #endif
 
 // vim: set sw=4 ts=4 et:
@@ -14,6 +14,8 @@ enum WMAction {
     ICEWM_ACTION_SUSPEND = 9,
     ICEWM_ACTION_WINOPTIONS = 10,
     ICEWM_ACTION_RELOADKEYS = 11,
+    ICEWM_ACTION_STATISTICS = 12,
+    ICEWM_ACTION_LATENCY = 13,
 };
 
 enum RebootShutdown {
@@ -29,6 +29,8 @@
 #include "udir.h"
 #include "ascii.h"
 #include "ycursor.h"
+#include "ymempool.h"
+#include "ylatency.h"
 #include "yxcontext.h"
 #ifdef CONFIG_XFREETYPE
 #include <ft2build.h>
@@ -36,6 +38,7 @@
 #endif
 #undef override
 #include <X11/Xproto.h>
+#include <X11/extensions/sync.h>
 #include "ywordexp.h"
 #include "intl.h"
 
@@ -219,8 +222,8 @@ static void registerNetProtocols(Window xid) {
         _XA_NET_WM_STATE_STICKY,            // trivial support
         _XA_NET_WM_STRUT,
         _XA_NET_WM_STRUT_PARTIAL,           // trivial support
-//      _XA_NET_WM_SYNC_REQUEST,
-//      _XA_NET_WM_SYNC_REQUEST_COUNTER,
+        _XA_NET_WM_SYNC_REQUEST,
+        _XA_NET_WM_SYNC_REQUEST_COUNTER,
         _XA_NET_WM_USER_TIME,
         _XA_NET_WM_USER_TIME_WINDOW,
         _XA_NET_WM_VISIBLE_ICON_NAME,       // trivial support
@@ -817,11 +820,12 @@ void YWMApp::runCommandOnce(const char *resource, const char *cmdline, long *pid
     }
 }
 
-bool YWMApp::mapClientByPid(const char* resource, long pid) {
-    if (isEmpty(resource))
+bool YWMApp::mapClientByPid(const char* name, long pid) {
+    if (isEmpty(name))
         return false;
 
     bool found = false;
+    ClassMatch resource(name);
 
     for (YFrameIter frame = manager->focusedIterator(); ++frame; ) {
         long tmp = 0;
@@ -1133,6 +1137,7 @@ static void showExtensions() {
         { "xrandr",    &xrandr    },
         { "xinerama",  &xinerama  },
         { "xshm",      &xshm      },
+        { "xsync",     &xsync     },
     };
     printf("[name]   [ver] [ev][err]\n");
     for (auto ext : pairs) {
@@ -1225,6 +1230,7 @@ YWMApp::YWMApp(int *argc, char ***argv, const char *displayName,
     catchSignal(SIGQUIT);
     catchSignal(SIGHUP);
     catchSignal(SIGCHLD);
+    catchSignal(SIGUSR1);
     catchSignal(SIGUSR2);
     catchSignal(SIGPIPE);
 
@@ -1363,6 +1369,7 @@ YWMApp::~YWMApp() {
     keyProgs.clear();
     workspaces.reset();
     WPixRes::freePixmaps();
+    Graphics::freeGradients();
 
     extern void clearFontCache();
     clearFontCache();
@@ -1416,6 +1423,10 @@ void YWMApp::handleSignal(int sig) {
         actionPerformed(actionRestart, 0);
         break;
 
+    case SIGUSR1:
+        YLatency::dumpStatistics();
+        break;
+
     case SIGUSR2:
         tlog("logEvents %s", boolstr(toggleLogEvents()));
         break;
@@ -1446,7 +1457,7 @@ bool YWMApp::handleIdle() {
         splashWindow = null;
         splashTimer = null;
     }
-    else if (taskBar) {
+    else if (taskBar && taskBar->needsRelayout()) {
         taskBar->relayoutNow();
     }
     return busy;
@@ -1464,6 +1475,14 @@ bool YWMApp::filterEvent(const XEvent &xev) {
             exit(0);
         }
     }
+    else if (xsync.isEvent(xev.type, XSyncAlarmNotify)) {
+        const XSyncAlarmNotifyEvent& notify =
+            reinterpret_cast<const XSyncAlarmNotifyEvent &>(xev);
+        YFrameWindow* frame = frameContext.find(notify.alarm);
+        if (frame)
+            frame->client()->handleSyncAlarm(xev);
+        return true;
+    }
     return YSMApplication::filterEvent(xev);
 }
 
@@ -1871,11 +1890,20 @@ void YWMApp::handleSMAction(WMAction message) {
         { ICEWM_ACTION_WINOPTIONS,    actionWinOptions },
         { ICEWM_ACTION_RELOADKEYS,    actionReloadKeys },
     };
+    if (message == ICEWM_ACTION_STATISTICS)
+        return dumpStatistics();
+    if (message == ICEWM_ACTION_LATENCY)
+        return YLatency::dumpStatistics();
     for (auto p : pairs)
         if (message == p.left)
             return actionPerformed(p.right);
 }
 
+void YWMApp::dumpStatistics() {
+    YMemPool::dumpStatistics();
+    Graphics::dumpGradientStatistics();
+}
+
 class SplashWindow : public YWindow {
     ref<YImage> image;
 public:
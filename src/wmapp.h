@@ -62,6 +62,7 @@ public:
     void doLogout(RebootShutdown reboot);
     void logout();
     void cancelLogout();
+    void dumpStatistics();
 
 #ifdef CONFIG_SESSION
     virtual void smSaveYourselfPhase2();
@@ -20,6 +20,8 @@ inline YColor YFrameButton::background(bool active) {
     return YFrameTitleBar::background(active);
 }
 
+YMemPool YFrameButton::pool("YFrameButton", sizeof(YFrameButton), 64);
+
 YFrameButton::YFrameButton(YFrameTitleBar* parent, char kind) :
     YButton(parent, actionNull),
     fKind(kind),
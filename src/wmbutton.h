@@ -2,6 +2,7 @@
 #define __WMBUTTON_H
 
 #include "yactionbutton.h"
+#include "ymempool.h"
 
 class YFrameWindow;
 class YFrameTitleBar;
@@ -10,6 +11,10 @@ class YFrameButton: public YButton {
 public:
     YFrameButton(YFrameTitleBar *parent, char kind);
     virtual ~YFrameButton();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     virtual void paint(Graphics &g, const YRect &r);
     virtual void paintFocus(Graphics &g, const YRect &r);
@@ -38,6 +43,7 @@ private:
 
     char fKind;
     bool fVisible;
+    static YMemPool pool;
 };
 
 #endif
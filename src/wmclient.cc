@@ -17,6 +17,7 @@
 #include "workspaces.h"
 #include "wmminiicon.h"
 #include "intl.h"
+#include <X11/extensions/sync.h>
 
 bool operator==(const XSizeHints& a, const XSizeHints& b) {
     long mask = PMinSize | PMaxSize | PResizeInc |
@@ -42,6 +43,8 @@ bool operator!=(const XSizeHints& a, const XSizeHints& b) {
     return !(a == b);
 }
 
+YMemPool YFrameClient::pool("YFrameClient", sizeof(YFrameClient), 32);
+
 YFrameClient::YFrameClient(YWindow *parent, YFrameWindow *frame, Window win,
                            int depth, Visual *visual, Colormap colormap):
     YDndWindow(parent, win, depth, visual, colormap),
@@ -58,6 +61,10 @@ YFrameClient::YFrameClient(YWindow *parent, YFrameWindow *frame, Window win,
     fTimedOut = false;
     fPinging = false;
     fPingTime = 0;
+    fSyncCounter = None;
+    fSyncAlarm = None;
+    fSyncValue = 0;
+    fSyncWaiting = false;
     fHints = nullptr;
     fWinHints = 0;
     fSavedFrameState = InvalidFrameState;
@@ -102,6 +109,8 @@ YFrameClient::YFrameClient(YWindow *parent, YFrameWindow *frame, Window win,
 }
 
 YFrameClient::~YFrameClient() {
+    syncStop();
+
     if (getFrame()) {
         frameContext.remove(handle());
     }
@@ -129,6 +138,7 @@ void YFrameClient::getProtocols(bool force) {
                 (wmp[i] == _XA_WM_DELETE_WINDOW) ? wpDeleteWindow :
                 (wmp[i] == _XA_WM_TAKE_FOCUS) ? wpTakeFocus :
                 (wmp[i] == _XA_NET_WM_PING) ? wpPing :
+                (wmp[i] == _XA_NET_WM_SYNC_REQUEST) ? wpSyncRequest :
                 0;
         }
         XFree(wmp);
@@ -189,6 +199,7 @@ void YFrameClient::getClassHint() {
 
     fClassHint.reset();
     XGetClassHint(xapp->display(), handle(), &fClassHint);
+    fClassHint.intern();
 }
 
 void YFrameClient::getTransient() {
@@ -342,6 +353,13 @@ void YFrameClient::sendPing() {
 }
 
 bool YFrameClient::handleTimer(YTimer* timer) {
+    if (fSyncTimer == timer) {
+        fSyncTimer = null;
+        fSyncWaiting = false;
+        if (fFrame)
+            fFrame->applyPendingResize();
+        return false;
+    }
     if (fPingTimer == timer) {
         fPingTimer = null;
         fPinging = false;
@@ -431,6 +449,102 @@ void YFrameClient::recvPing(const XClientMessageEvent &message) {
     }
 }
 
+static XSyncValue syncValue(unsigned long long value) {
+    XSyncValue result;
+    XSyncIntsToValue(&result, unsigned(value), int(value >> 32));
+    return result;
+}
+
+static unsigned long long syncValue(const XSyncValue& value) {
+    return (unsigned long long) unsigned(XSyncValueHigh32(value)) << 32
+         | XSyncValueLow32(value);
+}
+
+bool YFrameClient::syncStart() {
+    if (fSyncAlarm)
+        return true;
+    if (!xsync.supported || !protocol(wpSyncRequest) || destroyed() ||
+        fFrame == nullptr)
+        return false;
+
+    YProperty prop(this, _XA_NET_WM_SYNC_REQUEST_COUNTER, F32, 1, XA_CARDINAL);
+    if (prop == false || *prop == None)
+        return false;
+    fSyncCounter = XID(*prop);
+
+    // Continue from the current value, which the client may have raised
+    // for an earlier window manager, so the alarm cannot fire too early.
+    if (fSyncValue == 0) {
+        XSyncValue value;
+        if (XSyncQueryCounter(xapp->display(), fSyncCounter, &value) == False)
+            return false;
+        fSyncValue = syncValue(value);
+    }
+
+    XSyncAlarmAttributes attr;
+    attr.trigger.counter = fSyncCounter;
+    attr.trigger.value_type = XSyncAbsolute;
+    attr.trigger.wait_value = syncValue(fSyncValue);
+    attr.trigger.test_type = XSyncPositiveComparison;
+    attr.delta = syncValue(0ULL);
+    attr.events = True;
+    fSyncAlarm = XSyncCreateAlarm(xapp->display(),
+                                  XSyncCACounter | XSyncCAValueType |
+                                  XSyncCAValue | XSyncCATestType |
+                                  XSyncCADelta | XSyncCAEvents,
+                                  &attr);
+    if (fSyncAlarm)
+        frameContext.save(fSyncAlarm, fFrame);
+    fSyncWaiting = false;
+    return fSyncAlarm != None;
+}
+
+void YFrameClient::syncStop() {
+    if (fSyncAlarm) {
+        frameContext.remove(fSyncAlarm);
+        XSyncDestroyAlarm(xapp->display(), fSyncAlarm);
+        fSyncAlarm = None;
+    }
+    fSyncTimer = null;
+    fSyncWaiting = false;
+}
+
+// Ask the client to raise its counter after the next configure.
+bool YFrameClient::syncRequest() {
+    if (fSyncAlarm == None || fSyncWaiting)
+        return false;
+
+    XSyncAlarmAttributes attr;
+    attr.trigger.wait_value = syncValue(++fSyncValue);
+    XSyncChangeAlarm(xapp->display(), fSyncAlarm, XSyncCAValue, &attr);
+    sendMessage(_XA_NET_WM_SYNC_REQUEST, xapp->getEventTime("syncRequest"),
+                long(unsigned(fSyncValue)), long(fSyncValue >> 32));
+    fSyncWaiting = true;
+    // Do not let a hung client freeze the resize.
+    fSyncTimer->setTimer(200L, this, true);
+    return true;
+}
+
+void YFrameClient::handleSyncAlarm(const XEvent &xev) {
+    const XSyncAlarmNotifyEvent& notify =
+        reinterpret_cast<const XSyncAlarmNotifyEvent &>(xev);
+    if (notify.alarm != fSyncAlarm || fSyncAlarm == None)
+        return;
+    if (notify.state == XSyncAlarmDestroyed) {
+        frameContext.remove(fSyncAlarm);
+        fSyncAlarm = None;
+        fSyncCounter = None;
+        fSyncValue = 0;
+    }
+    else if (syncValue(notify.counter_value) < fSyncValue) {
+        return;
+    }
+    fSyncTimer = null;
+    fSyncWaiting = false;
+    if (fFrame)
+        fFrame->applyPendingResize();
+}
+
 void YFrameClient::setFrame(YFrameWindow *newFrame) {
     if (newFrame != getFrame()) {
         if (getFrame()) {
@@ -1143,8 +1257,9 @@ bool YFrameClient::isDockApp() const {
 }
 
 bool YFrameClient::isDockAppIcon() const {
+    static const YSymbol dockApp("DockApp");
     if ((wmHint(StateHint) && fHints->initial_state == WithdrawnState) ||
-        (fClassHint.res_class && 0 == strcmp(fClassHint.res_class, "DockApp")) ||
+        fClassHint.klass == dockApp ||
         (fSizeHints &&
          hasbits(fSizeHints->flags, USPosition | USSize) &&
          fSizeHints->x == 0 && fSizeHints->width == 64 &&
@@ -1307,24 +1422,48 @@ bool YFrameClient::getWinIcons(Atom* type, long* count, long** elem) {
     return false;
 }
 
-bool YFrameClient::getNetWMIcon(long* count, long** elems) {
-    *count = 0;
-    *elems = nullptr;
-    if (prop.net_wm_icon) {
-        YProperty prop(this, _XA_NET_WM_ICON, F32, 1L << 22);
-        if (prop) {
-            if (prop.typed(XA_CARDINAL)) {
-                *count = prop.size();
-                *elems = prop.retrieve<long>();
-            }
-            else if (testOnce("_NET_WM_ICON", int(handle()))) {
+/*
+ * Read only the headers of the images in _NET_WM_ICON.
+ * For each image append its width, height and the offset of its pixels.
+ */
+bool YFrameClient::getNetWMIconSizes(YArray<long>& sizes) {
+    sizes.clear();
+    if (prop.net_wm_icon == false)
+        return false;
+
+    long total = 2L;
+    for (long offset = 0; offset + 2 <= total; ) {
+        YProperty prop(this, _XA_NET_WM_ICON, F32, 2L,
+                       AnyPropertyType, False, offset);
+        if (prop == false || prop.size() < 2)
+            break;
+        if (prop.typed(XA_CARDINAL) == false) {
+            if (testOnce("_NET_WM_ICON", int(handle()))) {
                 TLOG(("Bad _NET_WM_ICON for window 0x%lx: N=%ld, F=%d, T=%s",
                      handle(), prop.size(), F32,
                      XGetAtomName(xapp->display(), prop.type())));
             }
+            break;
         }
+        if (offset == 0)
+            total = min(2L + long(prop.more() / 4), 1L << 22);
+
+        long w = prop[0], h = prop[1];
+        if (w <= 0 || h <= 0 || w > (total - offset - 2) / h)
+            break;
+        sizes += w;
+        sizes += h;
+        sizes += offset + 2;
+        offset += 2 + w * h;
     }
-    return (*elems != nullptr);
+    return sizes.nonempty();
+}
+
+// Read count pixels of _NET_WM_ICON at offset. Free with XFree.
+long* YFrameClient::getNetWMIconPixels(long offset, long count) {
+    YProperty prop(this, _XA_NET_WM_ICON, F32, count,
+                   XA_CARDINAL, False, offset);
+    return prop && long(prop.size()) == count ? prop.retrieve<long>() : nullptr;
 }
 
 void YFrameClient::setWorkspaceHint(int wk) {
@@ -1445,7 +1584,8 @@ void YFrameClient::getWindowRole() {
         return;
 
     Atom atom = prop.wm_window_role ? _XA_WM_WINDOW_ROLE : _XA_WINDOW_ROLE;
-    fWindowRole = YProperty(this, atom, F8, 256, XA_STRING).data<char>();
+    YProperty role(this, atom, F8, 256, XA_STRING);
+    fWindowRole = role.data<char>();
 }
 
 mstring YFrameClient::getClientId(Window leader) { /// !!! fix
@@ -1679,22 +1819,34 @@ void YFrameClient::handleGravityNotify(const XGravityEvent &gravity) {
     }
 }
 
-bool ClassHint::match(const char* resource) const {
-    if (isEmpty(resource))
+void ClassMatch::reset(const char* resource) {
+    fResource = YSymbol(resource);
+    fSplits.clear();
+    if (fResource.nonempty()) {
+        for (const char* dot = strchr(resource, '.'); dot;
+             dot = strchr(dot + 1, '.'))
+        {
+            fSplits.append(YSymbol(resource, dot - resource));
+            fSplits.append(YSymbol(dot + 1));
+        }
+    }
+}
+
+bool ClassHint::match(const ClassMatch& resource) const {
+    if (resource.fResource.isEmpty())
         return false;
-    if (*resource != '.') {
-        if (isEmpty(res_name))
-            return false;
-        size_t len(strlen(res_name));
-        if (strncmp(res_name, resource, len))
-            return false;
-        if (resource[len] == 0)
-            return true;
-        if (resource[len] != '.')
-            return false;
-        resource += len;
+    const YArray<YSymbol>& splits(resource.fSplits);
+    if (*resource.fResource.c_str() == '.')
+        return klass == splits[1];
+    if (instance.isEmpty())
+        return false;
+    if (instance == resource.fResource)
+        return true;
+    for (int i = 0; i < splits.getCount(); i += 2) {
+        if (splits[i] == instance)
+            return splits[i + 1] == klass;
     }
-    return 0 == strcmp(1 + resource, res_class ? res_class : "");
+    return false;
 }
 
 char* ClassHint::resource() const {
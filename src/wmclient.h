@@ -4,6 +4,8 @@
 #include "ywindow.h"
 #include "ymenu.h"
 #include "MwmUtil.h"
+#include "ymempool.h"
+#include "ysymbol.h"
 #ifndef InputHint
 #include <X11/Xutil.h>
 #endif
@@ -33,6 +35,22 @@ enum WindowType {
     wtUtility,
 };
 
+/*
+ * A resource "instance.class", "instance" or ".class", as symbols.
+ * Instances may contain dots, so keep a split at every dot.
+ */
+class ClassMatch {
+public:
+    explicit ClassMatch(const char* resource = nullptr) { reset(resource); }
+    void reset(const char* resource);
+    bool nonempty() const { return fResource.nonempty(); }
+
+private:
+    friend class ClassHint;
+    YSymbol fResource;
+    YArray<YSymbol> fSplits; // pairs of an instance and a class
+};
+
 class ClassHint : public XClassHint {
 public:
     ClassHint() { res_name = res_class = nullptr; }
@@ -42,12 +60,25 @@ public:
     void init(const char* name, const char* klas) {
         res_name = name ? strdup(name) : nullptr;
         res_class = klas ? strdup(klas) : nullptr;
+        intern();
     }
     void reset() {
         if (res_name) { XFree(res_name); res_name = nullptr; }
         if (res_class) { XFree(res_class); res_class = nullptr; }
+        instance = klass = YSymbol();
     }
-    bool match(const char* resource) const;
+    // Update the symbols after a change to res_name or res_class.
+    void intern() {
+        instance = YSymbol(res_name);
+        klass = YSymbol(res_class);
+    }
+    // Like intern, for a transient hint. Strings which were never
+    // interned get the empty symbol and so match nothing.
+    void lookup() {
+        instance = YSymbol::find(res_name);
+        klass = YSymbol::find(res_class);
+    }
+    bool match(const ClassMatch& resource) const;
     char* resource() const;
     void operator=(const ClassHint& hint) {
         if (this != &hint) {
@@ -56,19 +87,17 @@ public:
         }
     }
     bool operator==(const ClassHint& hint) {
-        return ((res_name && hint.res_name) ?
-                !strcmp(res_name, hint.res_name) :
-                res_name == hint.res_name) &&
-               ((res_class && hint.res_class) ?
-                !strcmp(res_class, hint.res_class) :
-                res_class == hint.res_class);
+        return instance == hint.instance && klass == hint.klass;
     }
     bool operator!=(const ClassHint& hint) {
         return !operator==(hint);
     }
     bool nonempty() {
-        return ::nonempty(res_name) || ::nonempty(res_class);
+        return instance.nonempty() || klass.nonempty();
     }
+
+    YSymbol instance;
+    YSymbol klass;
 };
 
 /*
@@ -173,6 +202,10 @@ public:
     YFrameClient(YWindow *parent, YFrameWindow *frame, Window win = 0,
                  int depth = 0, Visual *visual = nullptr, Colormap cmap = 0);
     virtual ~YFrameClient();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     virtual void handleProperty(const XPropertyEvent &property);
     virtual void handleColormap(const XColormapEvent &colormap);
@@ -192,6 +225,7 @@ public:
         wpDeleteWindow = 1 << 0,
         wpTakeFocus    = 1 << 1,
         wpPing         = 1 << 2,
+        wpSyncRequest  = 1 << 3,
     };
 
     bool protocol(WindowProtocols wp) const { return bool(fProtocols & wp); }
@@ -200,6 +234,16 @@ public:
     void sendDelete();
     void sendPing();
     void recvPing(const XClientMessageEvent &message);
+
+    // Interactive resizing waits for the client to redraw each size
+    // when it supports _NET_WM_SYNC_REQUEST. A request raises the wait
+    // value of an alarm on the client counter. The frame is told when
+    // the client reaches that value or a timeout expires.
+    bool syncStart();
+    void syncStop();
+    bool syncRequest();
+    bool syncWaiting() const { return fSyncWaiting; }
+    void handleSyncAlarm(const XEvent &xev);
     bool killPid();
     bool timedOut() const { return fTimedOut; }
 
@@ -271,7 +315,8 @@ public:
 
     bool getWinIcons(Atom* type, long* count, long** elem);
     bool getKwmIcon(long* count, Pixmap** pixmap);
-    bool getNetWMIcon(long* count, long** elem);
+    bool getNetWMIconSizes(YArray<long>& sizes);
+    long* getNetWMIconPixels(long offset, long count);
 
     bool getNetWMStateHint(int* mask, int* state);
     bool getNetWMDesktopHint(int* workspace);
@@ -335,6 +380,11 @@ private:
     bool fPinging;
     long fPingTime;
     lazy<YTimer> fPingTimer;
+    XID fSyncCounter;
+    XID fSyncAlarm;
+    unsigned long long fSyncValue;
+    bool fSyncWaiting;
+    lazy<YTimer> fSyncTimer;
     int fWinHints;
     long fPid;
 
@@ -387,6 +437,8 @@ private:
 private: // not-used
     YFrameClient(const YFrameClient &);
     YFrameClient &operator=(const YFrameClient &);
+
+    static YMemPool pool;
 };
 
 #endif // YCLIENT_H
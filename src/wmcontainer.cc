@@ -10,6 +10,8 @@
 #include "wmapp.h"
 #include "prefs.h"
 
+YMemPool YClientContainer::pool("YClientContainer", sizeof(YClientContainer), 32);
+
 YClientContainer::YClientContainer(YWindow *parent, YFrameWindow *frame,
                                    int depth, Visual *visual, Colormap cmap)
     : YWindow(parent, None, depth, visual, cmap)
@@ -2,6 +2,7 @@
 #define __WMCONTAINER_H
 
 #include "ywindow.h"
+#include "ymempool.h"
 
 class YFrameWindow;
 
@@ -10,6 +11,10 @@ public:
     YClientContainer(YWindow *parent, YFrameWindow *frame,
                      int depth, Visual *visual, Colormap colormap);
     virtual ~YClientContainer();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     virtual void handleButton(const XButtonEvent &button);
     virtual void handleConfigureRequest(const XConfigureRequestEvent &configureRequest);
@@ -27,6 +32,7 @@ private:
     YFrameWindow *fFrame;
     bool fHaveGrab;
     bool fHaveActionGrab;
+    static YMemPool pool;
 };
 
 #endif
@@ -222,6 +222,7 @@ int DockApp::ordering(YFrameClient* client, bool* startClose, bool* forced) {
                 XFree(name);
                 name = copy;
                 client->classHint()->res_name = copy;
+                client->classHint()->intern();
             }
         }
     }
@@ -234,7 +235,7 @@ int DockApp::ordering(YFrameClient* client, bool* startClose, bool* forced) {
 
     int order = 0;
     if (nonempty(name)) {
-        WindowOption opt(name);
+        WindowOption opt;
         if (hintOptions)
             hintOptions->mergeWindowOption(opt, name, true);
         if (defOptions)
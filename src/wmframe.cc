@@ -32,6 +32,8 @@ lazy<YTimer> YFrameWindow::fAutoRaiseTimer;
 lazy<YTimer> YFrameWindow::fDelayFocusTimer;
 YArray<YFrameWindow::GroupModal> YFrameWindow::groupModals;
 
+YMemPool YFrameWindow::pool("YFrameWindow", sizeof(YFrameWindow), 32);
+
 YFrameWindow::YFrameWindow(
     YActionListener *wmActionListener, unsigned dep, Visual* vis, Colormap col)
     : YWindow(nullptr, None, dep ? dep : xapp->depth(),
@@ -55,6 +57,7 @@ YFrameWindow::YFrameWindow(
     fPopupActive(nullptr),
     movingWindow(false),
     sizingWindow(false),
+    sizingPending(false),
     topSide(None),
     leftSide(None),
     rightSide(None),
@@ -1883,6 +1886,7 @@ void YFrameWindow::popupSystemMenu(YWindow *owner, int x, int y,
 }
 
 void YFrameWindow::updateTitle() {
+    manager->switchTitlesChanged();
     layoutShape();
     if (fTitleBar)
         fTitleBar->repaint();
@@ -2110,31 +2114,42 @@ WindowOption YFrameWindow::getWindowOption() {
 void YFrameWindow::getWindowOptions(WindowOptions *list, WindowOption &opt,
                                     bool remove)
 {
+    if (list->isEmpty())
+        return;
+
+    // Look up, rather than intern, to keep per-window strings
+    // out of the symbol table. Absent strings have no options.
     const ClassHint* h = client()->classHint();
-    mstring klass(h->res_class);
-    mstring name(h->res_name);
+    YSymbol klass(h->klass);
+    YSymbol name(h->instance);
     mstring role(client()->windowRole());
 
-    if (klass != null) {
-        if (name != null) {
-            mstring klass_instance(h->res_class, ".", h->res_name);
-            list->mergeWindowOption(opt, klass_instance, remove);
+    if (klass.nonempty()) {
+        if (name.nonempty()) {
+            YSymbol klass_instance(YSymbol::find(klass.c_str(), ".",
+                                                 name.c_str()));
+            if (klass_instance.nonempty())
+                list->mergeWindowOption(opt, klass_instance, remove);
 
-            mstring name_klass(h->res_name, ".", h->res_class);
-            list->mergeWindowOption(opt, name_klass, remove);
+            YSymbol name_klass(YSymbol::find(name.c_str(), ".",
+                                             klass.c_str()));
+            if (name_klass.nonempty())
+                list->mergeWindowOption(opt, name_klass, remove);
         }
         list->mergeWindowOption(opt, klass, remove);
     }
-    if (name != null) {
+    if (name.nonempty()) {
         if (role != null) {
-            mstring name_role = name.append(".").append(role);
-            list->mergeWindowOption(opt, name_role, remove);
+            YSymbol name_role(YSymbol::find(name.c_str(), ".", role));
+            if (name_role.nonempty())
+                list->mergeWindowOption(opt, name_role, remove);
         }
         list->mergeWindowOption(opt, name, remove);
     }
-    if (role != null)
-        list->mergeWindowOption(opt, role, remove);
-    list->mergeWindowOption(opt, null, remove);
+    YSymbol roleSymbol(YSymbol::find(role));
+    if (roleSymbol.nonempty())
+        list->mergeWindowOption(opt, roleSymbol, remove);
+    list->mergeWindowOption(opt, YSymbol(), remove);
 }
 
 void YFrameWindow::getDefaultOptions(bool &requestFocus) {
@@ -2274,64 +2289,100 @@ void YFrameWindow::updateIcon() {
 
     ref<YIcon> oldFrameIcon = fFrameIcon;
 
-    if (client()->getNetWMIcon(&count, &elem)) {
-        ref<YImage> icons[3], largestIcon;
+    YArray<long> headers;
+    if (client()->getNetWMIconSizes(headers)) {
         const long sizes[3] = {
             long(YIcon::smallSize()),
             long(YIcon::largeSize()),
             long(YIcon::hugeSize())
         };
-        long* largestOffset = nullptr;
+        // Offsets into headers of the images to use for each size.
+        int chosen[3] = { -1, -1, -1 };
+        int largest = -1;
         long largestSize = 0;
 
         // Find icons that match Small-/Large-/HugeIconSize and search
         // for the largest icon from NET_WM_ICON set.
-        for (long *e = elem;
-             e + 2 < elem + count && e[0] > 0 && e[1] > 0;
-             e += 2 + e[0] * e[1]) {
-            long w = e[0], h = e[1], *d = e + 2;
-            if (w == h && d + w*h <= elem + count) {
+        for (int k = 0; k + 2 < headers.getCount(); k += 3) {
+            long w = headers[k], h = headers[k + 1];
+            if (w == h) {
                 // Maybe huge=large=small, so examine all sizes[].
                 for (int i = 0; i < 3; i++) {
-                    if (w == sizes[i] && icons[i] == null) {
-                        if (i >= 1 && sizes[i - 1] == sizes[i]) {
-                            icons[i] = icons[i - 1];
-                        } else {
-                            icons[i] = YImage::createFromIconProperty(d, w, h);
-                            if (w > largestSize) {
-                                largestOffset = d;
-                                largestSize = w;
-                                largestIcon = icons[i];
-                            }
+                    if (w == sizes[i] && chosen[i] < 0) {
+                        chosen[i] = k;
+                        if (w > largestSize) {
+                            largest = k;
+                            largestSize = w;
                         }
                     }
                 }
                 if ((w > largestSize && largestSize < sizes[2]) ||
                     (w > sizes[2] && w < largestSize))
                 {
-                    largestOffset = d;
+                    largest = k;
                     largestSize = w;
                 }
             }
         }
 
-        // Create missing icons by scaling the largest icon.
-        for (int i = 0; i < 3; i++) {
-            if (icons[i] == null) {
-                // create the largest icon
-                if (largestIcon == null && largestOffset && largestSize) {
-                    largestIcon =
-                        YImage::createFromIconProperty(largestOffset,
-                                                       largestSize,
-                                                       largestSize);
+        // Fetch only the pixels of the selected images. The largest
+        // is only needed to scale the sizes which are missing.
+        int wanted[4] = { chosen[0], chosen[1], chosen[2],
+            (chosen[0] < 0 || chosen[1] < 0 || chosen[2] < 0) ? largest : -1
+        };
+        int same[4] = { 0, 1, 2, 3 };
+        long* pixels[4] = {};
+        unsigned long long hash = 14695981039346656037ULL;
+        auto mix = [&hash] (long value) {
+            hash = (hash ^ (unsigned long) value) * 1099511628211ULL;
+        };
+        for (int j = 0; j < 4; j++) {
+            int k = wanted[j];
+            for (int i = 0; i < j; i++) {
+                if (k >= 0 && k == wanted[i]) {
+                    same[j] = same[i];
+                    pixels[j] = pixels[i];
                 }
-                if (largestIcon != null) {
-                    icons[i] = largestIcon->scale(sizes[i], sizes[i]);
+            }
+            if (k >= 0 && same[j] == j) {
+                long size = headers[k] * headers[k + 1];
+                pixels[j] = client()->getNetWMIconPixels(headers[k + 2], size);
+                if (pixels[j]) {
+                    mix(headers[k]);
+                    for (long p = 0; p < size; ++p)
+                        mix(pixels[j][p]);
                 }
             }
+            mix(pixels[j] ? same[j] : -1);
+        }
+
+        // Windows of one application mostly share the same icon.
+        ref<YIcon> icon(YIcon::getPixelIcon(hash));
+        if (icon == null) {
+            ref<YImage> images[4];
+            for (int j = 0; j < 4; j++) {
+                if (same[j] < j)
+                    images[j] = images[same[j]];
+                else if (pixels[j]) {
+                    long w = headers[wanted[j]];
+                    images[j] = YImage::createFromIconProperty(pixels[j], w, w);
+                }
+            }
+            // Create missing icons by scaling the largest icon.
+            for (int i = 0; i < 3; i++) {
+                if (images[i] == null && images[3] != null) {
+                    images[i] = images[3]->scale(sizes[i], sizes[i]);
+                }
+            }
+            icon.init(new YIcon(images[0], images[1], images[2]));
+            YIcon::addPixelIcon(hash, icon);
+        }
+        fFrameIcon = icon;
+
+        for (int j = 0; j < 4; j++) {
+            if (pixels[j] && same[j] == j)
+                XFree(pixels[j]);
         }
-        fFrameIcon.init(new YIcon(icons[0], icons[1], icons[2]));
-        XFree(elem);
     }
     else if (client()->getWinIcons(&type, &count, &elem)) {
         if (type == _XA_WIN_ICONS)
@@ -2386,7 +2437,7 @@ void YFrameWindow::updateIcon() {
         fTrayApp->repaint();
     if (fTaskBarApp)
         fTaskBarApp->repaint();
-    if (windowList && fWinListItem && windowList->visible())
+    if (windowList && fWinListItem)
         windowList->repaintItem(fWinListItem);
 }
 
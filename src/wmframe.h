@@ -7,6 +7,7 @@
 #include "ylist.h"
 #include "WinMgr.h"
 #include "workspaces.h"
+#include "ymempool.h"
 
 class YClientContainer;
 class MiniIcon;
@@ -31,6 +32,10 @@ public:
                  Visual* visual = nullptr,
                  Colormap clmap = CopyFromParent);
     virtual ~YFrameWindow();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     void doManage(YFrameClient *client, bool &doActivate, bool &requestFocus);
     void afterManage();
@@ -116,6 +121,7 @@ public:
                        int sideX, int sideY,
                        int mouseXroot, int mouseYroot);
     void endMoveSize();
+    void applyPendingResize();
     void moveWindow(int newX, int newY);
     void manualPlace();
     void snapTo(int &wx, int &wy,
@@ -451,6 +457,8 @@ private:
     int buttonDownX, buttonDownY;
     int grabX, grabY;
     bool movingWindow, sizingWindow;
+    bool sizingPending;
+    YRect sizingRect;
     int origX, origY, origW, origH;
 
     Window topSide, leftSide, rightSide, bottomSide;
@@ -544,6 +552,7 @@ private:
         YFrameWindow* operator->() const { return frame; }
     };
     static YArray<GroupModal> groupModals;
+    static YMemPool pool;
     bool isGroupModalFor(const YFrameWindow* other) const;
     bool isTransientFor(const YFrameWindow* other) const;
 };
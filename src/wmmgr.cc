@@ -28,6 +28,7 @@
 #include "ystring.h"
 #include "intl.h"
 #include "ywordexp.h"
+#include "ygrid.h"
 
 YContext<YFrameClient> clientContext("clientContext", false);
 YContext<YFrameWindow> frameContext("framesContext", false);
@@ -308,6 +309,12 @@ SwitchWindow* YWindowManager::getSwitchWindow() {
     return fSwitchWindow;
 }
 
+// Measure new titles ahead of the next activation of the switcher.
+void YWindowManager::switchTitlesChanged() {
+    if (quickSwitchMaxWidth && getSwitchWindow())
+        fSwitchWindow->titlesChanged();
+}
+
 bool YWindowManager::switchWindowVisible() const {
     return fSwitchWindow && fSwitchWindow->visible();
 }
@@ -859,6 +866,8 @@ void YWindowManager::handleClientMessage(const XClientMessageEvent &message) {
         case ICEWM_ACTION_ABOUT:
         case ICEWM_ACTION_WINOPTIONS:
         case ICEWM_ACTION_RELOADKEYS:
+        case ICEWM_ACTION_STATISTICS:
+        case ICEWM_ACTION_LATENCY:
             smActionListener->handleSMAction(action);
             break;
         }
@@ -888,10 +897,11 @@ void YWindowManager::handleFocus(const XFocusChangeEvent &focus) {
     }
 }
 
-Window YWindowManager::findWindow(const char *resource) {
-    if (isEmpty(resource))
+Window YWindowManager::findWindow(const char *name) {
+    if (isEmpty(name))
         return None;
 
+    ClassMatch resource(name);
     for (YFrameIter iter = focusedReverseIterator(); ++iter; ) {
         YFrameClient* cli(iter->client());
         if (cli && cli->adopted() && !cli->destroyed()) {
@@ -916,9 +926,9 @@ Window YWindowManager::findWindow(const char *resource) {
     return match;
 }
 
-Window YWindowManager::findWindow(Window win, char const* resource,
+Window YWindowManager::findWindow(Window win, const ClassMatch& resource,
                                   int maxdepth) {
-    if (isEmpty(resource))
+    if (resource.nonempty() == false)
         return None;
 
     Window match = None, parent, root;
@@ -940,10 +950,12 @@ Window YWindowManager::findWindow(Window win, char const* resource,
     return match;
 }
 
-bool YWindowManager::matchWindow(Window win, char const* resource) {
+bool YWindowManager::matchWindow(Window win, const ClassMatch& resource) {
     ClassHint hint;
-    return XGetClassHint(xapp->display(), handle(), &hint)
-        && hint.match(resource);
+    if (XGetClassHint(xapp->display(), win, &hint) == False)
+        return false;
+    hint.lookup();
+    return hint.match(resource);
 }
 
 YFrameWindow *YWindowManager::findFrame(Window win) {
@@ -1202,35 +1214,23 @@ static int addco(int *v, int &n, int c) {
     return 1;
 }
 
-int YWindowManager::calcCoverage(bool down, YFrameWindow *frame1, int x, int y, int w, int h) {
+// The grid holds the frames which may be covered, in stacking order.
+int YWindowManager::calcCoverage(YRectGrid& grid, bool down,
+                                 int x, int y, int w, int h)
+{
     int cover = 0;
-    int factor = down ? 2 : 1; // try harder not to cover top windows
     const YRect rect(x, y, w, h);
 
-    YFrameWindow *frame = nullptr;
-
-    if (down) {
-        frame = top(frame1->getActiveLayer());
-    } else {
-        frame = frame1;
-    }
-    for (YFrameWindow * f = frame; f ; f = (down ? f->next() : f->prev())) {
-        if (f == frame1 || f->isMinimized() || f->isHidden() || !f->isManaged())
-            continue;
-
-        if (!f->isAllWorkspaces() && f->getWorkspace() != frame1->getWorkspace())
-            continue;
-
-        cover += rect.overlap(f->geometry()) * factor;
-
-        if (factor > 1)
-            factor /= 2;
+    for (int i : grid.query(rect)) {
+        // try harder not to cover top windows
+        int factor = (down && i == 0) ? 2 : 1;
+        cover += rect.overlap(grid[i]) * factor;
     }
     //msg("coverage %d %d %d %d = %d", x, y, w, h, cover);
     return cover;
 }
 
-void YWindowManager::tryCover(bool down, YFrameWindow *frame,
+void YWindowManager::tryCover(YRectGrid& grid, bool down,
                               int x, int y, int w, int h,
                               int& px, int& py, int& cover,
                               int mx, int my, int Mx, int My)
@@ -1246,7 +1246,7 @@ void YWindowManager::tryCover(bool down, YFrameWindow *frame,
     if (y + h > My)
         return ;
 
-    ncover = calcCoverage(down, frame, x, y, w, h);
+    ncover = calcCoverage(grid, down, x, y, w, h);
     if (ncover < cover) {
         //msg("min: %d %d %d", ncover, x, y);
         px = x;
@@ -1287,16 +1287,26 @@ bool YWindowManager::getSmartPlace(bool down, YFrameWindow *frame1, int &x, int
         return false;
     }
 
+    // Index the frames to find the few which overlap each candidate.
+    int cells = 1;
+    while (cells * cells < n / 2 && cells < 32)
+        ++cells;
+    YRectGrid grid(YRect(mx, my, Mx - mx, My - my), cells, cells);
+
     xcount = ycount = 0;
     addco(xcoord, xcount, mx);
     addco(ycoord, ycount, my);
     for (f = frame; f; f = (down ? f->next() : f->prev())) {
-        if (f == frame1 || f->isMinimized() || f->isHidden() || !f->isManaged() || f->isMaximized())
+        if (f == frame1 || f->isMinimized() || f->isHidden() || !f->isManaged())
             continue;
 
         if (!f->isAllWorkspaces() && f->getWorkspace() != frame1->getWorkspace())
             continue;
 
+        grid.add(f->geometry());
+        if (f->isMaximized())
+            continue;
+
         addco(xcoord, xcount, f->x());
         addco(xcoord, xcount, f->x() + f->width());
         addco(ycoord, ycount, f->y());
@@ -1309,15 +1319,15 @@ bool YWindowManager::getSmartPlace(bool down, YFrameWindow *frame1, int &x, int
 
     int xn = 0, yn = 0;
     px = x; py = y;
-    cover = calcCoverage(down, frame1, x, y, w, h);
+    cover = calcCoverage(grid, down, x, y, w, h);
     while (true) {
         x = xcoord[xn];
         y = ycoord[yn];
 
-        tryCover(down, frame1, x - w, y - h, w, h, px, py, cover, mx, my, Mx, My);
-        tryCover(down, frame1, x - w, y    , w, h, px, py, cover, mx, my, Mx, My);
-        tryCover(down, frame1, x    , y - h, w, h, px, py, cover, mx, my, Mx, My);
-        tryCover(down, frame1, x    , y    , w, h, px, py, cover, mx, my, Mx, My);
+        tryCover(grid, down, x - w, y - h, w, h, px, py, cover, mx, my, Mx, My);
+        tryCover(grid, down, x - w, y    , w, h, px, py, cover, mx, my, Mx, My);
+        tryCover(grid, down, x    , y - h, w, h, px, py, cover, mx, my, Mx, My);
+        tryCover(grid, down, x    , y    , w, h, px, py, cover, mx, my, Mx, My);
 
         if (cover == 0)
             break;
@@ -1703,6 +1713,7 @@ void YWindowManager::manageClient(YFrameClient* client, bool mapClient) {
         if (switchWindowVisible())
             fSwitchWindow->createdFrame(frame);
     }
+    switchTitlesChanged();
     updateFullscreenLayerEnable(true);
 }
 
@@ -2111,21 +2122,21 @@ void YWindowManager::getWorkAreaSize(YFrameWindow *frame, int *Mw,int *Mh) {
     *Mh = My - my;
 }
 
-void YWindowManager::updateArea(long workspace, int screen_number,
-                                int l, int t, int r, int b)
-{
-    long low = 0, lim = fWorkAreaWorkspaceCount - 1L;
-    if (inrange(workspace, low, lim)) {
-        low = lim = workspace;
-    } else if (workspace != WinWorkspaceInvalid) {
-        return;
-    }
-    for (long ws = low; ws <= lim; ++ws) {
-        WorkAreaRect *wa = fWorkArea[ws] + screen_number;
-        if (l > wa->fMinX) wa->fMinX = l;
-        if (t > wa->fMinY) wa->fMinY = t;
-        if (r < wa->fMaxX) wa->fMaxX = r;
-        if (b < wa->fMaxY) wa->fMaxY = b;
+// Bound the work area of one workspace and screen
+// by the limits of all windows which apply to it.
+void YWindowManager::limitWorkArea(long workspace, int screen) {
+    WorkAreaRect *wa = fWorkArea[workspace] + screen;
+    *wa = xiInfo[screen];
+    for (const WorkAreaLimit& lim : fWorkAreaLimits) {
+        if (lim.fScreen == screen &&
+            (lim.fWorkspace == workspace ||
+             lim.fWorkspace == WinWorkspaceInvalid))
+        {
+            if (lim.fLeft > wa->fMinX) wa->fMinX = lim.fLeft;
+            if (lim.fTop > wa->fMinY) wa->fMinY = lim.fTop;
+            if (lim.fRight < wa->fMaxX) wa->fMaxX = lim.fRight;
+            if (lim.fBottom < wa->fMaxY) wa->fMaxY = lim.fBottom;
+        }
     }
 }
 
@@ -2163,35 +2174,17 @@ void YWindowManager::updateWorkArea() {
     }
 }
 
-bool YWindowManager::updateWorkAreaInner() {
-    long oldWorkAreaWorkspaceCount = fWorkAreaWorkspaceCount;
-    int oldWorkAreaScreenCount = fWorkAreaScreenCount;
-    WorkAreaRect **oldWorkArea = new WorkAreaRect *[::workspaceCount];
-    if (oldWorkArea == nullptr)
-        return false;
-    else {
-        long areaCount = ::workspaceCount * getScreenCount();
-        oldWorkArea[0] = new WorkAreaRect[areaCount];
-        if (oldWorkArea[0] == nullptr) {
-            delete[] oldWorkArea;
-            return false;
-        }
-        else {
-            fWorkAreaWorkspaceCount = ::workspaceCount;
-            fWorkAreaScreenCount = getScreenCount();
-            swap(fWorkArea, oldWorkArea);
-        }
-    }
-
-    for (long i = 0; i < fWorkAreaWorkspaceCount; i++) {
-        if (i)
-            fWorkArea[i] = fWorkArea[i - 1] + fWorkAreaScreenCount;
-        for (int j = 0; j < fWorkAreaScreenCount; j++)
-            fWorkArea[i][j] = xiInfo[j];
+// Collect how each window with struts or at a screen edge
+// limits the work area of its workspace and screen.
+void YWindowManager::getWorkAreaLimits(YArray<WorkAreaLimit>& limits) {
+    // Include the screens, to notice when their geometry changes.
+    for (int s = 0; s < xiInfo.getCount(); ++s) {
+        const DesktopScreenInfo& info(xiInfo[s]);
+        limits.append({ WinWorkspaceInvalid, s, info.x_org, info.y_org,
+                        info.x_org + int(info.width),
+                        info.y_org + int(info.height) });
     }
 
-    debugWorkArea("before");
-
     for (YFrameWindow *w = topLayer(); w; w = w->nextLayer()) {
         if (w->isUnmapped()) {
             continue;
@@ -2217,7 +2210,7 @@ bool YWindowManager::updateWorkAreaInner() {
             MSG(("strut %d %d %d %d", w->strutLeft(), w->strutTop(),
                                       w->strutRight(), w->strutBottom()));
             MSG(("limit %d %d %d %d", l, t, r, b));
-            updateArea(ws, s, l, t, r, b);
+            limits.append({ ws, s, l, t, r, b });
         }
 
         if (w->doNotCover() ||
@@ -2255,42 +2248,100 @@ bool YWindowManager::updateWorkAreaInner() {
                 }
             }
             MSG(("dock limit %d %d %d %d", l, t, r, b));
-            updateArea(ws, s, l, t, r, b);
+            limits.append({ ws, s, l, t, r, b });
         }
-        debugWorkArea("updated");
     }
-    debugWorkArea("after");
+}
 
-    bool changed = false;
-    if (oldWorkArea == nullptr ||
-        oldWorkAreaWorkspaceCount != fWorkAreaWorkspaceCount ||
-        oldWorkAreaScreenCount != fWorkAreaScreenCount) {
-        changed = true;
-    } else {
-        for (long ws = 0; ws < fWorkAreaWorkspaceCount; ws++) {
-            for (int s = 0; s < fWorkAreaScreenCount; s++) {
-                if (fWorkArea[ws][s] != oldWorkArea[ws][s]) {
-                    changed = true;
-                    break;
+bool YWindowManager::updateWorkAreaInner() {
+    YArray<WorkAreaLimit> limits;
+    getWorkAreaLimits(limits);
+
+    const long spaces = ::workspaceCount;
+    const int screens = getScreenCount();
+    const bool reshaped = (fWorkArea == nullptr ||
+                           fWorkAreaWorkspaceCount != spaces ||
+                           fWorkAreaScreenCount != screens);
+
+    // Only the areas of windows whose limits differ need recomputing.
+    YArray<bool> dirty;
+    dirty.extend(spaces * screens);
+    bool anyDirty = reshaped;
+    auto touch = [&] (const WorkAreaLimit& lim) {
+        if (inrange(lim.fScreen, 0, screens - 1)) {
+            for (long ws = 0; ws < spaces; ws++) {
+                if (lim.fWorkspace == ws ||
+                    lim.fWorkspace == WinWorkspaceInvalid) {
+                    dirty[ws * screens + lim.fScreen] = true;
+                    anyDirty = true;
                 }
             }
-            if (changed)
-                break;
+        }
+    };
+    // The limits start with one entry per screen.
+    bool rescreened = (fWorkArea && fWorkAreaScreenCount != screens);
+    if (fWorkArea && rescreened == false) {
+        for (int s = 0; s < screens; ++s)
+            if (!(limits[s] == fWorkAreaLimits[s]))
+                rescreened = true;
+    }
+    if (reshaped) {
+        for (int i = 0; i < dirty.getCount(); ++i)
+            dirty[i] = true;
+    } else {
+        const int oldCount = fWorkAreaLimits.getCount();
+        const int newCount = limits.getCount();
+        for (int i = 0; i < max(oldCount, newCount); ++i) {
+            if (i < oldCount && i < newCount &&
+                limits[i] == fWorkAreaLimits[i])
+                continue;
+            if (i < oldCount)
+                touch(fWorkAreaLimits[i]);
+            if (i < newCount)
+                touch(limits[i]);
         }
     }
+    fWorkAreaLimits.swap(limits);
+    if (anyDirty == false)
+        return false;
+
+    long oldWorkAreaWorkspaceCount = fWorkAreaWorkspaceCount;
+    int oldWorkAreaScreenCount = fWorkAreaScreenCount;
+    WorkAreaRect **oldWorkArea = fWorkArea;
+    fWorkArea = new WorkAreaRect *[spaces];
+    fWorkArea[0] = new WorkAreaRect[spaces * screens];
+    fWorkAreaWorkspaceCount = spaces;
+    fWorkAreaScreenCount = screens;
+
+    bool changed = reshaped;
+    for (long ws = 0; ws < spaces; ws++) {
+        if (ws)
+            fWorkArea[ws] = fWorkArea[ws - 1] + screens;
+        for (int s = 0; s < screens; s++) {
+            bool& d = dirty[ws * screens + s];
+            if (d) {
+                limitWorkArea(ws, s);
+                d = reshaped || fWorkArea[ws][s] != oldWorkArea[ws][s];
+                changed |= d;
+            } else {
+                fWorkArea[ws][s] = oldWorkArea[ws][s];
+            }
+        }
+    }
+    debugWorkArea("after");
 
     bool resize = false;
     if (changed) {
         MSG(("announceWorkArea"));
         announceWorkArea();
-        long spaces = min(fWorkAreaWorkspaceCount, oldWorkAreaWorkspaceCount);
-        int screens = min(fWorkAreaScreenCount, oldWorkAreaScreenCount);
+        long minSpaces = min(spaces, oldWorkAreaWorkspaceCount);
+        int minScreens = min(screens, oldWorkAreaScreenCount);
         for (YFrameWindow* f = topLayer(); f; f = f->nextLayer()) {
             if (f->x() >= 0 && f->y() >= 0 && f->inWorkArea()) {
                 int s = f->getScreen();
                 int w = f->isAllWorkspaces()
                       ? activeWorkspace() : f->getWorkspace();
-                if (s < spaces && w < spaces &&
+                if (s < minScreens && w < minSpaces &&
                     fWorkArea[w][s].displaced(oldWorkArea[w][s])) {
                     int dx =
                         (f->x() >= oldWorkArea[w][s].fMinX &&
@@ -2318,8 +2369,8 @@ bool YWindowManager::updateWorkAreaInner() {
             resize = true;
         }
         else {
-            for (long ws = 0; ws < spaces; ws++) {
-                for (int s = 0; s < screens; s++) {
+            for (long ws = 0; ws < minSpaces; ws++) {
+                for (int s = 0; s < minScreens; s++) {
                     if (fWorkArea[ws][s].width() < oldWorkArea[ws][s].width())
                         resize = true;
                     if (fWorkArea[ws][s].height() < oldWorkArea[ws][s].height())
@@ -2333,10 +2384,32 @@ bool YWindowManager::updateWorkAreaInner() {
         delete [] oldWorkArea[0];
         delete [] oldWorkArea;
     }
-    if (resize) {
+    if (rescreened) {
+        // Fullscreen frames follow the screens, so refit all of them.
         MSG(("resizeWindows"));
         resizeWindows();
     }
+    else if (resize) {
+        // Only the work areas changed, on which only maximized frames
+        // depend.
+        MSG(("resize maximized"));
+        bool fewer = screens < oldWorkAreaScreenCount;
+        for (YFrameWindow* f = topLayer(); f; f = f->nextLayer()) {
+            if (f->isMaximized() && f->visibleNow() && f->inWorkArea() &&
+                !f->client()->destroyed())
+            {
+                int s = f->getScreen();
+                long w = f->isAllWorkspaces()
+                       ? activeWorkspace() : f->getWorkspace();
+                if (fewer || !inrange(s, 0, screens - 1) ||
+                    !inrange(w, 0L, spaces - 1L) || dirty[w * screens + s])
+                {
+                    f->updateDerivedSize(WinStateMaximizedBoth);
+                    f->updateLayout();
+                }
+            }
+        }
+    }
     return resize | changed;
 }
 
@@ -2870,7 +2943,7 @@ void YWindowManager::handleProperty(const XPropertyEvent &property) {
                     while (i < nitems && propdata[i++]);
                 }
                 if (s[0] && s[1] && s[2] && propdata[i - 1] == 0) {
-                    hintOptions->setWinOption(s[0], s[1], s[2]);
+                    hintOptions->setWinOption(YSymbol(s[0]), s[1], s[2]);
                 }
             }
         }
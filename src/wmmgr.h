@@ -10,10 +10,12 @@
 extern YAction layerActionSet[WinLayerCount];
 
 class YStringList;
+class YRectGrid;
 class YWindowManager;
 class YFrameClient;
 class YFrameWindow;
 class YSMListener;
+class ClassMatch;
 class SwitchWindow;
 class DockApp;
 class IApp;
@@ -102,8 +104,8 @@ public:
     void ungrabServer();
 
     Window findWindow(char const* resource);
-    Window findWindow(Window root, char const* resource, int maxdepth);
-    bool matchWindow(Window win, char const* resource);
+    Window findWindow(Window root, const ClassMatch& resource, int maxdepth);
+    bool matchWindow(Window win, const ClassMatch& resource);
 
     YFrameWindow *findFrame(Window win);
     YFrameClient *findClient(Window win);
@@ -126,8 +128,8 @@ public:
     void getWorkArea(const YFrameWindow *frame, int *mx, int *my, int *Mx, int *My, int xiscreen = -1);
     void getWorkAreaSize(YFrameWindow *frame, int *Mw,int *Mh);
 
-    int calcCoverage(bool down, YFrameWindow *frame, int x, int y, int w, int h);
-    void tryCover(bool down, YFrameWindow *frame, int x, int y, int w, int h,
+    int calcCoverage(YRectGrid& grid, bool down, int x, int y, int w, int h);
+    void tryCover(YRectGrid& grid, bool down, int x, int y, int w, int h,
                   int& px, int& py, int& cover, int mx, int my, int Mx, int My);
     bool getSmartPlace(bool down, YFrameWindow *frame, int &x, int &y, int w, int h, int xiscreen);
     void getNewPosition(YFrameWindow *frame, int &x, int &y, int w, int h, int xiscreen);
@@ -201,6 +203,7 @@ public:
     void setWorkspace(int workspace);
     void updateWorkArea();
     bool updateWorkAreaInner();
+    void limitWorkArea(long workspace, int screen);
     void debugWorkArea(const char* prefix);
     void workAreaUpdated();
     void resizeWindows();
@@ -295,6 +298,7 @@ public:
 
     bool switchWindowVisible() const;
     SwitchWindow* getSwitchWindow();
+    void switchTitlesChanged();
 
 private:
     struct WindowPosState {
@@ -305,7 +309,6 @@ private:
 
     YFrameClient* allocateClient(Window win, bool mapClient);
     YFrameWindow* allocateFrame(YFrameClient* client);
-    void updateArea(long workspace, int screen_number, int l, int t, int r, int b);
     bool handleWMKey(const XKeyEvent &key, KeySym k, unsigned vm);
     void setWmState(WMState newWmState);
     void refresh();
@@ -348,6 +351,20 @@ private:
         }
     } **fWorkArea;
 
+    // How one window bounds the work area of a workspace and screen.
+    struct WorkAreaLimit {
+        long fWorkspace;
+        int fScreen;
+        int fLeft, fTop, fRight, fBottom;
+        bool operator==(const WorkAreaLimit& o) const {
+            return fWorkspace == o.fWorkspace && fScreen == o.fScreen
+                && fLeft == o.fLeft && fTop == o.fTop
+                && fRight == o.fRight && fBottom == o.fBottom;
+        }
+    };
+    YArray<WorkAreaLimit> fWorkAreaLimits;
+    void getWorkAreaLimits(YArray<WorkAreaLimit>& limits);
+
     YObjectArray<EdgeSwitch> edges;
     bool fShuttingDown;
     int fArrangeCount;
@@ -492,8 +509,8 @@ extern Atom _XA_NET_WM_STATE_SKIP_TASKBAR;          // OK
 extern Atom _XA_NET_WM_STATE_STICKY;                // OK (trivial)
 extern Atom _XA_NET_WM_STRUT;                       // OK
 extern Atom _XA_NET_WM_STRUT_PARTIAL;               // OK (minimal)
-extern Atom _XA_NET_WM_SYNC_REQUEST;                // TODO
-extern Atom _XA_NET_WM_SYNC_REQUEST_COUNTER;        // TODO
+extern Atom _XA_NET_WM_SYNC_REQUEST;                // OK (resize)
+extern Atom _XA_NET_WM_SYNC_REQUEST_COUNTER;        // OK (resize)
 extern Atom _XA_NET_WM_USER_TIME;                   // OK
 extern Atom _XA_NET_WM_USER_TIME_WINDOW;            // OK
 extern Atom _XA_NET_WM_VISIBLE_ICON_NAME;           // OK
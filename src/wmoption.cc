@@ -13,7 +13,7 @@
 lazy<WindowOptions> defOptions;
 lazy<WindowOptions> hintOptions;
 
-WindowOption::WindowOption(mstring n_class_instance):
+WindowOption::WindowOption(YSymbol n_class_instance):
     w_class_instance(n_class_instance),
     functions(0), function_mask(0),
     decors(0), decor_mask(0),
@@ -79,17 +79,17 @@ void WindowOption::combine(const WindowOption& n) {
     }
 }
 
-bool WindowOptions::findOption(mstring a_class_instance, int *index) {
+// Options are ordered by symbol index, which is not alphabetical.
+bool WindowOptions::findOption(YSymbol a_class_instance, int *index) {
     int lo = 0, hi = fWinOptions.getCount();
 
     while (lo < hi) {
         const int pv = (lo + hi) / 2;
         const WindowOption *pivot = fWinOptions[pv];
 
-        int cmp = a_class_instance.compareTo(pivot->w_class_instance);
-        if (cmp > 0) {
+        if (pivot->w_class_instance < a_class_instance) {
             lo = pv + 1;
-        } else if (cmp < 0) {
+        } else if (a_class_instance < pivot->w_class_instance) {
             hi = pv;
         } else {
             *index = pv;
@@ -101,7 +101,7 @@ bool WindowOptions::findOption(mstring a_class_instance, int *index) {
     return false;
 }
 
-WindowOption* WindowOptions::getOption(mstring a_class_instance) {
+WindowOption* WindowOptions::getOption(YSymbol a_class_instance) {
     int where;
     if (findOption(a_class_instance, &where) == false) {
         fWinOptions.insert(where, new WindowOption(a_class_instance));
@@ -109,7 +109,7 @@ WindowOption* WindowOptions::getOption(mstring a_class_instance) {
     return fWinOptions[where];
 }
 
-void WindowOptions::setWinOption(mstring n_class_instance,
+void WindowOptions::setWinOption(YSymbol n_class_instance,
                                  const char *opt, const char *arg)
 {
     WindowOption *op = getOption(n_class_instance);
@@ -281,7 +281,7 @@ void WindowOptions::setWinOption(mstring n_class_instance,
 }
 
 void WindowOptions::mergeWindowOption(WindowOption &cm,
-                                      mstring a_class_instance,
+                                      YSymbol a_class_instance,
                                       bool remove)
 {
     int lo;
@@ -345,7 +345,7 @@ static char *parseWinOptions(char *data, const char* filename) {
             *dest++ = *scan;
         }
 
-        mstring class_instance(word, dest - word);
+        YSymbol class_instance(word, dest - word);
 
         *end = 0;
         opt = 1 + dot;
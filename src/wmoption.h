@@ -4,12 +4,13 @@
 #include "upath.h"
 #include "yarray.h"
 #include "ypointer.h"
+#include "ysymbol.h"
 
 struct WindowOption {
-    WindowOption(mstring n_class_instance = null);
+    explicit WindowOption(YSymbol n_class_instance = YSymbol());
     void combine(const WindowOption& n);
 
-    mstring w_class_instance;
+    YSymbol w_class_instance;
     mstring keyboard;
     mstring icon;
     unsigned functions, function_mask;
@@ -27,12 +28,20 @@ struct WindowOption {
 
 class WindowOptions {
 public:
-    void setWinOption(mstring n_class_instance,
+    void setWinOption(YSymbol n_class_instance,
                       const char *opt, const char *arg);
 
     void mergeWindowOption(WindowOption &cm,
-                           mstring a_class_instance,
+                           YSymbol a_class_instance,
                            bool remove);
+    void mergeWindowOption(WindowOption &cm,
+                           mstring a_class_instance,
+                           bool remove) {
+        // A string which was never interned cannot name an option.
+        YSymbol sym(YSymbol::find(a_class_instance.c_str()));
+        if (sym.nonempty())
+            mergeWindowOption(cm, sym, remove);
+    }
 
     int getCount() const { return fWinOptions.getCount(); }
     bool nonempty() const { return fWinOptions.nonempty(); }
@@ -41,9 +50,9 @@ public:
 private:
     YObjectArray<WindowOption> fWinOptions;
 
-    bool findOption(mstring a_class_instance, int *index);
+    bool findOption(YSymbol a_class_instance, int *index);
 
-    WindowOption *getOption(mstring a_class_instance);
+    WindowOption *getOption(YSymbol a_class_instance);
 };
 
 extern lazy<WindowOptions> defOptions;
@@ -50,9 +50,11 @@ class WindowItemsCtrlr : public ISwitchItems
 {
     int zTarget;
     YArray<YFrameWindow*> zList;
+    YArray<ZItem> fItems;
     YFrameWindow *fActiveWindow;
     YFrameWindow *fLastWindow;
     char *fWMClass;
+    ClassMatch fClassMatch;
 
     void freeList() {
         zList.clear();
@@ -125,6 +127,7 @@ public:
         if (fWMClass)
             free(fWMClass);
         fWMClass = wmclass;
+        fClassMatch.reset(wmclass);
     }
 
     virtual char* getWMClass() override {
@@ -135,7 +138,7 @@ public:
         YFrameWindow* const focused = manager->getFocus();
         int const current = manager->activeWorkspace();
         int const count = manager->focusedCount();
-        ZItem items[count];
+        fItems.shrink(0);
         int index = 0;
 
         for (YFrameIter iter(manager->focusedReverseIterator()); ++iter; ) {
@@ -153,8 +156,8 @@ public:
                     continue;
             }
 
-            if (nonempty(fWMClass)) {
-                if (client->classHint()->match(fWMClass) == false)
+            if (fClassMatch.nonempty()) {
+                if (client->classHint()->match(fClassMatch) == false)
                     continue;
             }
 
@@ -183,18 +186,18 @@ public:
                 prio = 2;
             }
             if (prio && index < count) {
-                items[index].prio = prio;
-                items[index].index = index;
-                items[index].frame = frame;
+                ZItem item = { prio, index, frame };
+                fItems += item;
                 index += 1;
             }
         }
 
-        qsort(items, size_t(index), sizeof(ZItem), ZItem::compare);
+        if (index > 1)
+            qsort(&fItems[0], size_t(index), sizeof(ZItem), ZItem::compare);
 
-        zList.clear();
-        for (int i = 0; i < index; ++i) {
-            zList += items[i].frame;
+        zList.shrink(0);
+        for (const ZItem& item : fItems) {
+            zList += item.frame;
         }
 
         if (fActiveWindow && find(zList, fActiveWindow) < 0)
@@ -272,7 +275,8 @@ public:
             (client->adopted() || frame->visible()) &&
             (frame->isUrgent() || quickSwitchToAllWorkspaces ||
              frame->visibleOn(manager->activeWorkspace())) &&
-            (isEmpty(fWMClass) || client->classHint()->match(fWMClass)) &&
+            (fClassMatch.nonempty() == false ||
+             client->classHint()->match(fClassMatch)) &&
             !frame->frameOption(YFrameWindow::foIgnoreQSwitch) &&
             (!frame->isHidden() || quickSwitchToHidden) &&
             (!frame->isMinimized() || quickSwitchToMinimized))
@@ -354,6 +358,81 @@ SwitchWindow::~SwitchWindow() {
     delete zItems;
 }
 
+// The index of title in fTitles, or -1 and where to insert it.
+int SwitchWindow::findTitle(const mstring& title, int* position) {
+    int lo = 0, hi = fTitles.getCount();
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = title.compareTo(fTitles[mid]);
+        if (cmp == 0)
+            return *position = mid;
+        else if (cmp < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    *position = lo;
+    return -1;
+}
+
+// Only the widest title needs all titles measured. Otherwise measure
+// just the one title which is shown and don't keep it.
+int SwitchWindow::titleWidth(const mstring& title) {
+    if (quickSwitchMaxWidth == false)
+        return int(switchFont->textWidth(title));
+    int lo;
+    if (findTitle(title, &lo) >= 0)
+        return fTitleWidths[lo];
+    int width = int(switchFont->textWidth(title));
+    fTitles.insert(lo, title);
+    fTitleWidths.insert(lo, width);
+    return width;
+}
+
+void SwitchWindow::titlesChanged() {
+    if (fWarmTimer == nullptr || fWarmTimer->isRunning() == false)
+        fWarmTimer->setTimer(250L, this, true);
+}
+
+bool SwitchWindow::handleTimer(YTimer* timer) {
+    if (timer == fWarmTimer && switchFont)
+        warmTitles();
+    return false;
+}
+
+// Measure the titles of all windows before the next activation,
+// and forget the titles of windows which are gone or renamed.
+void SwitchWindow::warmTitles() {
+    titleWidth(" ");
+    for (YFrameIter frame(manager->focusedReverseIterator()); ++frame; ) {
+        mstring title(frame->client()->windowTitle());
+        if (title != null)
+            titleWidth(title);
+    }
+
+    YArray<bool> live;
+    live.extend(fTitles.getCount());
+    int index;
+    if (findTitle(" ", &index) >= 0)
+        live[index] = true;
+    for (YFrameIter frame(manager->focusedReverseIterator()); ++frame; ) {
+        mstring title(frame->client()->windowTitle());
+        if (title != null && findTitle(title, &index) >= 0)
+            live[index] = true;
+    }
+
+    MStringArray titles;
+    YArray<int> widths;
+    for (int i = 0; i < live.getCount(); ++i) {
+        if (live[i]) {
+            titles.append(fTitles[i]);
+            widths.append(fTitleWidths[i]);
+        }
+    }
+    fTitles.swap(titles);
+    fTitleWidths.swap(widths);
+}
+
 void SwitchWindow::resize(int xiscreen, bool reposition) {
     int dx, dy;
     unsigned dw, dh;
@@ -371,16 +450,16 @@ void SwitchWindow::resize(int xiscreen, bool reposition) {
 
     int tWidth = 0;
     if (quickSwitchMaxWidth && switchFont) {
-        int space = (int) switchFont->textWidth(" ");   /* make entries one space character wider */
+        int space = titleWidth(" ");   /* make entries one space character wider */
         int zCount = zItems->getCount();
         for (int i = 0; i < zCount; i++) {
             mstring title = zItems->getTitle(i);
-            int oWidth = title != null ? (int) switchFont->textWidth(title) + space : 0;
+            int oWidth = title != null ? titleWidth(title) + space : 0;
             if (oWidth > tWidth)
                 tWidth = oWidth;
         }
     } else {
-        tWidth = cTitle != null && switchFont ? switchFont->textWidth(cTitle) : 0;
+        tWidth = cTitle != null && switchFont ? titleWidth(cTitle) : 0;
     }
 
     if (m_verticalStyle || !quickSwitchAllIcons)
@@ -517,7 +596,7 @@ void SwitchWindow::paintHorizontal(Graphics &g) {
         mstring cTitle = zItems->getTitle(zItems->getActiveItem());
         if (cTitle != null && switchFont) {
             const int x = max((width() - tOfs -
-                               switchFont->textWidth(cTitle)) >> 1, 0U) + tOfs;
+                               titleWidth(cTitle)) >> 1, 0U) + tOfs;
             const int y(quickSwitchAllIcons
                         ? quickSwitchTextFirst
                         ? quickSwitchVMargin + switchFont->ascent()
@@ -45,7 +45,7 @@ public:
     virtual YFrameWindow* current() const { return nullptr; }
 };
 
-class SwitchWindow: public YPopupWindow {
+class SwitchWindow: public YPopupWindow, private YTimerListener {
 public:
     SwitchWindow(YWindow* parent, ISwitchItems* items, bool verticalStyle);
     ~SwitchWindow();
@@ -64,6 +64,8 @@ public:
     virtual void handleMotion(const XMotionEvent& motion) override;
     void destroyedFrame(YFrameWindow* frame);
     void createdFrame(YFrameWindow* frame);
+    // A window was created or renamed.
+    void titlesChanged();
     YFrameWindow* current();
 
 private:
@@ -87,6 +89,15 @@ private:
 
     unsigned modsDown;
 
+    // Widths of window titles in switchFont, sorted by title.
+    MStringArray fTitles;
+    YArray<int> fTitleWidths;
+    int titleWidth(const mstring& title);
+    int findTitle(const mstring& title, int* position);
+    void warmTitles();
+    lazy<YTimer> fWarmTimer;
+    bool handleTimer(YTimer* timer) override;
+
     bool modDown(unsigned m);
     bool isModKey(KeyCode c);
     bool isKey(KeySym k, unsigned mod);
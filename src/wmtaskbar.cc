@@ -642,6 +642,14 @@ void TaskBar::relayoutNow() {
     }
 }
 
+// Whether relayoutNow has any work to do.
+bool TaskBar::needsRelayout() const {
+    return fUpdates.nonempty() || fNeedRelayout
+        || fButtonUpdate || fWorkspacesUpdate
+        || (windowTrayPane() && windowTrayPane()->needsRelayout())
+        || (taskPane() && taskPane()->needsRelayout());
+}
+
 void TaskBar::updateFullscreen(bool fullscreen) {
     if (fFullscreen != fullscreen && getFrame()) {
         fFullscreen = fullscreen;
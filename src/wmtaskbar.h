@@ -111,6 +111,7 @@ public:
 
     void relayout() { fNeedRelayout = true; }
     void relayoutNow();
+    bool needsRelayout() const;
 
     void detachDesktopTray();
 
@@ -42,6 +42,8 @@ YColor YFrameTitleBar::background(bool active) {
     return titleBarBackground[active];
 }
 
+YMemPool YFrameTitleBar::pool("YFrameTitleBar", sizeof(YFrameTitleBar), 32);
+
 YFrameTitleBar::YFrameTitleBar(YWindow *parent, YFrameWindow *frame):
     YWindow(parent),
     fFrame(frame),
@@ -1,6 +1,8 @@
 #ifndef WMTITLE_H
 #define WMTITLE_H
 
+#include "ymempool.h"
+
 class YFrameButton;
 class YFrameWindow;
 
@@ -8,6 +10,10 @@ class YFrameTitleBar: public YWindow {
 public:
     YFrameTitleBar(YWindow *parent, YFrameWindow *frame);
     virtual ~YFrameTitleBar();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     void activate();
     void deactivate();
@@ -59,6 +65,7 @@ private:
 
     enum { Count = 8, };
     YFrameButton* fButtons[Count];
+    static YMemPool pool;
 };
 
 #endif
@@ -19,6 +19,8 @@
 
 WindowListProxy windowList;
 
+YMemPool WindowListItem::pool("WindowListItem", sizeof(WindowListItem), 32);
+
 WindowListItem::WindowListItem(ClientData *frame, int workspace):
     fFrame(frame),
     fWorkspace(workspace)
@@ -573,8 +575,12 @@ void WindowList::updateWindowListApp(WindowListItem *item) {
     }
 }
 
+// A hidden list only keeps the width of the item up to date.
 void WindowList::repaintItem(WindowListItem *item) {
-    list->repaintItem(item);
+    if (visible())
+        list->repaintItem(item);
+    else
+        list->updateItem(item);
 }
 
 void WindowList::configure(const YRect2& r) {
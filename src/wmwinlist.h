@@ -6,6 +6,7 @@
 #include "yaction.h"
 #include "yarray.h"
 #include "ypointer.h"
+#include "ymempool.h"
 
 class WindowListItem;
 class WindowListBox;
@@ -17,6 +18,10 @@ class WindowListItem: public YListItem {
 public:
     WindowListItem(ClientData *frame, int workspace);
     virtual ~WindowListItem();
+    static void* operator new(size_t size) { return pool.allocate(size); }
+    static void operator delete(void* block, size_t size) {
+        pool.release(block, size);
+    }
 
     virtual int getOffset();
 
@@ -27,6 +32,7 @@ public:
 private:
     ClientData *fFrame;
     int fWorkspace;
+    static YMemPool pool;
 };
 
 class WindowListBox: public YListBox, public YActionListener {
@@ -7,6 +7,7 @@
 #include "yapp.h"
 #include "ypoll.h"
 #include "ytimer.h"
+#include "ylatency.h"
 #include "yprefs.h"
 #include "sysdep.h"
 #include "intl.h"
@@ -17,6 +18,7 @@
 #include <sys/signalfd.h>
 #endif
 #include "ywordexp.h"
+#include <typeinfo>
 
 IMainLoop *mainLoop;
 int DelayFuzziness = 10;
@@ -177,9 +179,14 @@ void YApplication::handleTimeouts() {
         {
             timeout = *iter;
             YTimerListener *listener = timeout->getTimerListener();
+            timeval late = now - timeout->timeout();
             timeout->stopTimer();
+            const bool measure = YLatency::enabled();
+            const timeval start = measure ? monotime() : now;
             if (listener && listener->handleTimer(timeout))
                 timeout->startTimer();
+            if (measure)
+                YLatency::timer(late, monotime() - start);
         }
     }
 }
@@ -206,7 +213,8 @@ YPollBase::~YPollBase() {
 
 void YPollBase::unregisterPoll() {
     if (fRegistered) {
-        mainLoop->unregisterPoll(this);
+        if (mainLoop)
+            mainLoop->unregisterPoll(this);
         fRegistered = false;
     }
 }
@@ -296,14 +304,20 @@ int YApplication::mainLoop() {
                 fail(_("%s: select failed"), __func__);
         } else {
             for (YPollIterType iPoll = polls.reverseIterator(); ++iPoll; ) {
-                if (iPoll->fd() >= 0 && FD_ISSET(iPoll->fd(), &read_fds)) {
+                const int fd = iPoll->fd();
+                const bool timing = YLatency::enabled() && fd >= 0 &&
+                    (FD_ISSET(fd, &read_fds) || FD_ISSET(fd, &write_fds));
+                const char* klass = timing ? typeid(**iPoll).name() : nullptr;
+                const timeval start = timing ? monotime() : zerotime();
+                if (fd >= 0 && FD_ISSET(fd, &read_fds)) {
                     iPoll->notifyRead();
-                    if (iPoll.isValid() == false)
-                        continue;
                 }
-                if (iPoll->fd() >= 0 && FD_ISSET(iPoll->fd(), &write_fds)) {
+                if (iPoll.isValid() &&
+                    iPoll->fd() >= 0 && FD_ISSET(iPoll->fd(), &write_fds)) {
                     iPoll->notifyWrite();
                 }
+                if (timing)
+                    YLatency::poll(klass, monotime() - start);
             }
         }
     }
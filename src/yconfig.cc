@@ -180,9 +180,40 @@ void YConfig::setOption(char* arg, bool append, cfoption* opt) {
     }
 }
 
+static unsigned hashName(const char* name, size_t length) {
+    unsigned hash = 2166136261U;
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ (unsigned char) name[i]) * 16777619U;
+    return hash;
+}
+
+// Hash all option names once, so lookups don't scan all options.
+// genpref cannot generate this table: it links with this library,
+// and some option tables are local arrays which genpref never sees.
+void YConfig::buildIndex() {
+    unsigned count = 0;
+    while (options[count].type)
+        ++count;
+    unsigned size = 16;
+    while (size < 2 * count)
+        size *= 2;
+    index = new unsigned[size]();
+    mask = size - 1;
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned slot = hashName(options[i].name, options[i].size - 1) & mask;
+        while (index[slot])
+            slot = (slot + 1) & mask;
+        index[slot] = i + 1;
+    }
+}
+
 cfoption* YConfig::findOption(char* name, size_t length) {
     if (length && *name) {
-        for (cfoption* opt = options; opt->type; ++opt) {
+        if (index == nullptr)
+            buildIndex();
+        unsigned slot = hashName(name, length) & mask;
+        for (; index[slot]; slot = (slot + 1) & mask) {
+            cfoption* opt = options + index[slot] - 1;
             if (opt->size == 1+length &&
                 *opt->name == *name &&
                 memcmp(name, opt->name, length) == 0)
@@ -282,6 +313,15 @@ bool YConfig::loadConfigFile(cfoption* opts, upath fileName,
     return buf;
 }
 
+bool YConfig::parseFile(upath fileName) {
+    YTraceConfig trace(fileName.string());
+    auto buf(fileName.loadText());
+    if (buf) {
+        parseConfiguration(buf);
+    }
+    return buf;
+}
+
 void YConfig::freeConfig(cfoption *options) {
     for (cfoption* o = options; o->type != cfoption::CF_NONE; ++o) {
         if (o->type == cfoption::CF_STR &&
@@ -299,7 +339,7 @@ bool YConfig::findLoadConfigFile(cfoption* options, const char* name) {
     return conf.nonempty() && YConfig::loadConfigFile(options, conf);
 }
 
-bool YConfig::findLoadThemeFile(cfoption* options) {
+upath YConfig::locateThemeFile() {
     upath init(themeName);
     upath name(init.isAbsolute() ? init : upath("themes") + init);
     upath conf = YApplication::locateConfigFile(name);
@@ -307,6 +347,11 @@ bool YConfig::findLoadThemeFile(cfoption* options) {
         if (name.getExtension() != ".theme")
             conf = YApplication::locateConfigFile(name + "default.theme");
     }
+    return conf;
+}
+
+bool YConfig::findLoadThemeFile(cfoption* options) {
+    upath conf = locateThemeFile();
     return conf.nonempty() && YConfig::loadConfigFile(options, conf);
 }
 
@@ -315,12 +360,14 @@ size_t YConfig::cfoptionSize() {
 }
 
 YConfig& YConfig::load(const char* file) {
-    success = findLoadConfigFile(options, file);
+    upath conf = YApplication::locateConfigFile(file);
+    success = conf.nonempty() && parseFile(conf);
     return *this;
 }
 
 YConfig& YConfig::loadTheme() {
-    success = findLoadThemeFile(options);
+    upath conf = locateThemeFile();
+    success = conf.nonempty() && parseFile(conf);
     return *this;
 }
 
@@ -155,8 +155,12 @@ class upath;
 class YConfig {
     cfoption* options;
     bool success;
+    unsigned* index;    // hash slots of options plus one
+    unsigned mask;
 public:
-    YConfig(cfoption* options) : options(options), success(false) { }
+    YConfig(cfoption* options) :
+        options(options), success(false), index(nullptr), mask(0) { }
+    ~YConfig() { delete[] index; }
     YConfig& load(const char* file);
     YConfig& loadTheme();
     YConfig& loadOverride();
@@ -172,6 +176,12 @@ public:
     static size_t cfoptionSize();
 
 private:
+    YConfig(const YConfig&) = delete;
+    YConfig& operator=(const YConfig&) = delete;
+
+    static upath locateThemeFile();
+    bool parseFile(upath fileName);
+    void buildIndex();
     cfoption* findOption(char* name, size_t length);
     static void setOption(char* arg, bool append, cfoption* opt);
     char* parseOption(char* str);
@@ -0,0 +1,88 @@
+/*
+ * IceWM - uniform grid for rectangle intersection queries
+ */
+#include "config.h"
+#include "yfull.h"
+#include "ygrid.h"
+#include <stdlib.h>
+
+YRectGrid::YRectGrid(const YRect& area, int columns, int rows) :
+    fArea(area),
+    fColumns(area.width() ? max(1, columns) : 1),
+    fRows(area.height() ? max(1, rows) : 1),
+    fCells(new YArray<int>[fColumns * fRows]),
+    fStamp(0)
+{
+}
+
+YRectGrid::~YRectGrid() {
+    delete[] fCells;
+}
+
+int YRectGrid::column(int x) const {
+    long offset = long(x) - fArea.x();
+    return offset <= 0 ? 0 :
+        int(min(offset * fColumns / long(max(1U, fArea.width())),
+                long(fColumns - 1)));
+}
+
+int YRectGrid::row(int y) const {
+    long offset = long(y) - fArea.y();
+    return offset <= 0 ? 0 :
+        int(min(offset * fRows / long(max(1U, fArea.height())),
+                long(fRows - 1)));
+}
+
+int YRectGrid::add(const YRect& rect) {
+    const int index = fRects.getCount();
+    fRects.append(rect);
+    fStamps.append(0);
+    if (rect.width() && rect.height()) {
+        int c1 = column(rect.x() + int(rect.width()) - 1);
+        int r1 = row(rect.y() + int(rect.height()) - 1);
+        for (int r = row(rect.y()); r <= r1; ++r)
+            for (int c = column(rect.x()); c <= c1; ++c)
+                fCells[r * fColumns + c].append(index);
+    }
+    return index;
+}
+
+static int compareIndex(const void* p1, const void* p2) {
+    return *static_cast<const int *>(p1) - *static_cast<const int *>(p2);
+}
+
+const YArray<int>& YRectGrid::query(const YRect& rect) {
+    fFound.shrink(0);
+    if (rect.width() == 0 || rect.height() == 0)
+        return fFound;
+
+    // Stamps mark the rectangles already seen in this query.
+    if (++fStamp == 0) {
+        for (int i = 0; i < fStamps.getCount(); ++i)
+            fStamps[i] = 0;
+        fStamp = 1;
+    }
+
+    const int x2 = rect.x() + int(rect.width());
+    const int y2 = rect.y() + int(rect.height());
+    const int c1 = column(x2 - 1);
+    const int r1 = row(y2 - 1);
+    for (int r = row(rect.y()); r <= r1; ++r) {
+        for (int c = column(rect.x()); c <= c1; ++c) {
+            for (int index : fCells[r * fColumns + c]) {
+                if (fStamps[index] != fStamp) {
+                    fStamps[index] = fStamp;
+                    const YRect& test(fRects[index]);
+                    if (test.x() < x2 && rect.x() < test.x() + int(test.width())
+                     && test.y() < y2 && rect.y() < test.y() + int(test.height()))
+                        fFound.append(index);
+                }
+            }
+        }
+    }
+    if (fFound.getCount() > 1)
+        qsort(&*fFound, size_t(fFound.getCount()), sizeof(int), compareIndex);
+    return fFound;
+}
+
+// vim: set sw=4 ts=4 et:
@@ -0,0 +1,45 @@
+#ifndef YGRID_H
+#define YGRID_H
+
+#include "yarray.h"
+#include "yrect.h"
+
+/*
+ * A uniform grid of buckets over an area, to find which of many
+ * rectangles intersect a given rectangle without testing all of them.
+ * Each rectangle is kept in every cell it covers. Rectangles which
+ * extend beyond the area are kept in the cells along its border.
+ * Rectangles are identified by the order in which they were added.
+ */
+class YRectGrid {
+public:
+    YRectGrid(const YRect& area, int columns, int rows);
+    ~YRectGrid();
+
+    // Add a rectangle and return its index.
+    int add(const YRect& rect);
+
+    int count() const { return fRects.getCount(); }
+    const YRect& operator[](int index) const { return fRects[index]; }
+
+    // The indexes of the rectangles which intersect rect, in the
+    // order they were added. Valid until the next query.
+    const YArray<int>& query(const YRect& rect);
+
+private:
+    int column(int x) const;
+    int row(int y) const;
+
+    YRect fArea;
+    int fColumns;
+    int fRows;
+    YArray<int>* fCells;
+    YArray<YRect> fRects;
+    YArray<unsigned> fStamps;
+    YArray<int> fFound;
+    unsigned fStamp;
+};
+
+#endif
+
+// vim: set sw=4 ts=4 et:
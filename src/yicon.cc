@@ -6,14 +6,17 @@
 #include "config.h"
 #include "ypaint.h"
 #include "yicon.h"
+#include "yiconloader.h"
 #include "prefs.h"
 #include "yprefs.h"
 #include "yxapp.h"
 #include "ypointer.h"
 #include "ywordexp.h"
 #include "ascii.h"
+#include "ylist.h"
 #include <fnmatch.h>
 #include <dirent.h>
+#include <sys/stat.h>
 #include "intl.h"
 
 // place holder for scalable category, a size beyond normal limits
@@ -23,7 +26,8 @@ IResourceLocator* YIcon::iconResourceLocator;
 
 YIcon::YIcon(upath filename) :
         fSmall(null), fLarge(null), fHuge(null), loadedS(false), loadedL(false),
-        loadedH(false), fCached(false), fPath(filename.expand())
+        loadedH(false), fCached(false), fBlocking(false), fHash(0),
+        fPath(filename.expand())
 {
     // don't attempt to load if icon is disabled
     if (fPath == "none" || fPath == "-")
@@ -33,10 +37,36 @@ YIcon::YIcon(upath filename) :
 YIcon::YIcon(ref<YImage> small, ref<YImage> large, ref<YImage> huge) :
         fSmall(small), fLarge(large), fHuge(huge), loadedS(small != null),
         loadedL(large != null), loadedH(huge != null), fCached(false),
-        fPath(null) {
+        fBlocking(false), fHash(0), fPath(null) {
+}
+
+// An image of other than the standard sizes. All of them are kept
+// in one list, from least to most recently used, to evict the least
+// recently used when their pixels exceed the budget.
+struct ScaledIcon : public YListNode<ScaledIcon> {
+    YIcon* icon;
+    unsigned size;
+    ref<YImage> image;
+    size_t bytes;
+};
+
+static YList<ScaledIcon> scaledList;
+static size_t scaledBytes;
+static const size_t scaledBudget = 4 << 20;
+
+static size_t imageBytes(ref<YImage> image) {
+    return image != null ? size_t(image->width()) * image->height() * 4 : 0;
+}
+
+static void forgetScaled(ScaledIcon* s) {
+    scaledList.remove(s);
+    scaledBytes -= s->bytes;
+    delete s;
 }
 
 YIcon::~YIcon() {
+    for (ScaledIcon* s : fScaled)
+        forgetScaled(s);
 }
 
 static const char iconExts[][5] = {
@@ -393,26 +423,24 @@ public:
         // for compaction reasons, the lambdas return true on success,
         // but the success is only found in _this_ lambda only,
         // and this is the only one which touches `result`!
-        auto checkFile = [&](upath path) {
-            return path.fileExists() ? (res = path, true) : false;
+        auto checkFile = [&](const char* path) {
+            struct stat st;
+            return stat(path, &st) == 0 && S_ISREG(st.st_mode)
+                 ? (res = path, true) : false;
         };
-        auto checkFilesAtBasePath = [&](mstring basePath, unsigned size,
+        auto checkFilesInFolder = [&](const mstring& dirPath, unsigned size,
                 bool addSizeSfx) {
-            // XXX: optimize string concatenation? Or go back to plain printf?
-            if (addSizeSfx) {
-                mstring szSize(size);
-                basePath = mstring(basePath, "_", szSize, "x", szSize);
-            }
+            char sizeSfx[32] = "";
+            if (addSizeSfx)
+                snprintf(sizeSfx, sizeof sizeSfx, "_%ux%u", size, size);
             for (auto& imgExt : iconExts) {
-                if (checkFile(basePath + imgExt))
+                MStringBuilder path;
+                path << dirPath << baseName << sizeSfx << imgExt;
+                if (checkFile(path.c_str()))
                     return true;
             }
             return false;
         };
-        auto checkFilesInFolder = [&](const mstring& dirPath, unsigned size,
-                bool addSizeSfx) {
-            return checkFilesAtBasePath(dirPath + baseName, size, addSizeSfx);
-        };
         auto smartScanFolder = [&](const mstring& folder, bool addSizeSfx,
                 unsigned probeAllButThis = 0) {
 
@@ -553,7 +581,10 @@ ref<YImage> YIcon::small() {
     return fSmall;
 }
 
-ref<YImage> YIcon::getScaledIcon(unsigned size) {
+ref<YImage> YIcon::getScaledIcon(unsigned size, YWindow* repaint) {
+    if (repaint && loadAsync(size, repaint))
+        return null;
+
     if (size == smallSize() && (loadedS ? fSmall != null : small() != null))
         return fSmall;
     if (size == largeSize() && (loadedL ? fLarge != null : large() != null))
@@ -561,6 +592,95 @@ ref<YImage> YIcon::getScaledIcon(unsigned size) {
     if (size == hugeSize() && (loadedH ? fHuge != null : huge() != null))
         return fHuge;
 
+    for (ScaledIcon* s : fScaled) {
+        if (s->size == size) {
+            if (s != scaledList.back()) {
+                scaledList.remove(s);
+                scaledList.append(s);
+            }
+            return s->image;
+        }
+    }
+
+    ref<YImage> image(scaleIcon(size));
+    cacheScaled(size, image);
+    return image;
+}
+
+// Keep a scaled image, after evicting the least recently used
+// images to stay within the budget.
+bool YIcon::cacheScaled(unsigned size, ref<YImage> image) {
+    size_t bytes = imageBytes(image);
+    if (bytes > scaledBudget)
+        return false;
+    while (scaledBytes + bytes > scaledBudget) {
+        ScaledIcon* old = scaledList.front();
+        findRemove(old->icon->fScaled, old);
+        forgetScaled(old);
+    }
+    ScaledIcon* s = new ScaledIcon;
+    s->icon = this;
+    s->size = size;
+    s->image = image;
+    s->bytes = bytes;
+    fScaled.append(s);
+    scaledList.append(s);
+    scaledBytes += bytes;
+    return true;
+}
+
+// Start a background decode when the image of this size is still
+// to be read from a file. Return true while the decode is pending.
+bool YIcon::loadAsync(unsigned size, YWindow* repaint) {
+    if (fBlocking || fPath == null)
+        return false;
+    if (YIconLoader::pending(this, size, repaint))
+        return true;
+
+    // Loaded images are quickly scaled.
+    if (loadedS || loadedL || loadedH)
+        return false;
+    for (ScaledIcon* s : fScaled)
+        if (s->size == size)
+            return false;
+
+    upath path(fPath.isAbsolute() && fPath.fileExists()
+               ? fPath : findIcon(size));
+    if (path != null && YIconLoader::canDecode(path) &&
+        YIconLoader::request(this, size, path, repaint))
+        return true;
+
+    fBlocking = true;
+    return false;
+}
+
+void YIcon::decoded(unsigned size, ref<YImage> image) {
+    if (image == null) {
+        fBlocking = true;
+    }
+    else if (size == smallSize()) {
+        if (loadedS == false)
+            fSmall = image, loadedS = true;
+    }
+    else if (size == largeSize()) {
+        if (loadedL == false)
+            fLarge = image, loadedL = true;
+    }
+    else if (size == hugeSize()) {
+        if (loadedH == false)
+            fHuge = image, loadedH = true;
+    }
+    else {
+        for (ScaledIcon* s : fScaled)
+            if (s->size == size)
+                return;
+        // Another decode would follow every repaint.
+        if (cacheScaled(size, image) == false)
+            fBlocking = true;
+    }
+}
+
+ref<YImage> YIcon::scaleIcon(unsigned size) {
     ref<YImage> base;
     if (size < smallSize() && (loadedS ? fSmall != null : small() != null))
         if ((base = fSmall->scale(size, size)) != null)
@@ -629,8 +749,48 @@ ref<YIcon> YIcon::getIcon(const char *name) {
     return newicon;
 }
 
+static YRefArray<YIcon> pixelCache;
+
+int YIcon::pixelFind(unsigned long long hash) {
+    int l = 0, r = pixelCache.getCount();
+    while (l < r) {
+        int m = (l + r) / 2;
+        unsigned long long found = pixelCache[m]->fHash;
+        if (hash == found)
+            return m;
+        else if (hash < found)
+            r = m;
+        else
+            l = m + 1;
+    }
+    return -(l + 1);
+}
+
+ref<YIcon> YIcon::getPixelIcon(unsigned long long hash) {
+    int n = pixelFind(hash);
+    if (n >= 0)
+        return pixelCache[n];
+    return null;
+}
+
+void YIcon::addPixelIcon(unsigned long long hash, ref<YIcon> icon) {
+    // Drop icons which are no longer used by any frame:
+    // only the cache and the temporary below refer to them.
+    for (int i = pixelCache.getCount(); --i >= 0; ) {
+        if (pixelCache[i]->__refcount <= 2)
+            pixelCache.remove(i);
+    }
+    int n = pixelFind(hash);
+    if (n < 0 && icon != null) {
+        icon->fHash = hash;
+        pixelCache.insert(-n - 1, icon);
+    }
+}
+
 void YIcon::freeIcons() {
+    YIconLoader::shutdown();
     iconCache.clear();
+    pixelCache.clear();
     iconIndex = null;
 }
 
@@ -650,8 +810,8 @@ unsigned YIcon::hugeSize() {
     return hugeIconSize;
 }
 
-bool YIcon::draw(Graphics& g, int x, int y, int size) {
-    ref<YImage> image = getScaledIcon(size);
+bool YIcon::draw(Graphics& g, int x, int y, int size, YWindow* repaint) {
+    ref<YImage> image = getScaledIcon(size, repaint);
     if (image != null) {
         if (!doubleBuffer) {
             g.drawImage(image, x, y);
@@ -1,6 +1,11 @@
 #ifndef YICON_H
 #define YICON_H
 
+#include "yarray.h"
+
+class YWindow;
+struct ScaledIcon;
+
 class YIcon: public refcounted {
 public:
     YIcon(upath fileName);
@@ -11,13 +16,20 @@ public:
     ref<YImage> large();
     ref<YImage> small();
 
-    ref<YImage> getScaledIcon(unsigned size);
+    // With a window to repaint, an image which must first be read
+    // from a file may be decoded in the background. Until then null.
+    ref<YImage> getScaledIcon(unsigned size, YWindow* repaint = nullptr);
+    // Receive an image which was decoded in the background.
+    void decoded(unsigned size, ref<YImage> image);
 
     upath iconName() const { return fPath; }
 
     static class IResourceLocator* iconResourceLocator;
     static ref<YIcon> getIcon(const char *name);
     static void freeIcons();
+    // Icons from client pixel data, shared by a hash of that data.
+    static ref<YIcon> getPixelIcon(unsigned long long hash);
+    static void addPixelIcon(unsigned long long hash, ref<YIcon> icon);
     bool isCached() { return fCached; }
     void setCached(bool cached) { fCached = cached; }
 
@@ -26,7 +38,8 @@ public:
     static unsigned largeSize();
     static unsigned hugeSize();
 
-    bool draw(Graphics &g, int x, int y, int size);
+    bool draw(Graphics &g, int x, int y, int size,
+              YWindow* repaint = nullptr);
     upath findIcon(unsigned size);
 
 #ifdef SUPPORT_XDG_ICON_TYPE_CATEGORIES
@@ -53,12 +66,22 @@ private:
     bool loadedL;
     bool loadedH;
     bool fCached;
+    // Decode synchronously, as background decoding failed.
+    bool fBlocking;
+    unsigned long long fHash;
 
     upath fPath;
 
+    // Images of other than the standard sizes, or null if none.
+    YArray<ScaledIcon*> fScaled;
+    bool cacheScaled(unsigned size, ref<YImage> image);
+
     void removeFromCache();
     static int cacheFind(upath name);
+    static int pixelFind(unsigned long long hash);
     ref<YImage> loadIcon(unsigned size);
+    bool loadAsync(unsigned size, YWindow* repaint);
+    ref<YImage> scaleIcon(unsigned size);
 };
 
 #endif
@@ -0,0 +1,359 @@
+/*
+ * IceWM - background decoding of icon files
+ */
+#include "config.h"
+#include "yxapp.h"
+#include "yimage.h"
+#include "yicon.h"
+#include "yiconloader.h"
+
+#if defined(CONFIG_GDK_PIXBUF_XLIB) || \
+    (defined(CONFIG_IMLIB2) && defined(CONFIG_LIBRSVG))
+#define ASYNC_ICONS 1
+#endif
+
+#ifdef ASYNC_ICONS
+
+#include "ypoll.h"
+#include "yxcontext.h"
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#ifndef CONFIG_GDK_PIXBUF_XLIB
+#include <librsvg/rsvg.h>
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace {
+
+struct Job {
+    // Only the main thread touches these.
+    ref<YIcon> icon;
+    YArray<Window> windows;
+
+    // Input and output of the decoder thread.
+    char* path;
+    unsigned size;
+    long* pixels;
+    unsigned width;
+    unsigned height;
+
+    Job(YIcon* icon, unsigned size, const char* path) :
+        icon(icon), path(strdup(path)), size(size),
+        pixels(nullptr), width(0), height(0) { }
+    ~Job() { free(path); delete[] pixels; }
+};
+
+// Read the file into a pixbuf which is size pixels square.
+GdkPixbuf* decodeFile(const char* path, unsigned size) {
+    GdkPixbuf* pixbuf = nullptr;
+    GError* error = nullptr;
+#ifdef CONFIG_GDK_PIXBUF_XLIB
+    pixbuf = gdk_pixbuf_new_from_file_at_scale(path, int(size), int(size),
+                                               FALSE, &error);
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    RsvgHandle* handle = rsvg_handle_new_from_file(path, &error);
+    if (handle) {
+        pixbuf = rsvg_handle_get_pixbuf(handle);
+        g_object_unref(G_OBJECT(handle));
+    }
+#pragma GCC diagnostic pop
+#endif
+    if (error)
+        g_clear_error(&error);
+    if (pixbuf && (gdk_pixbuf_get_width(pixbuf) != int(size) ||
+                   gdk_pixbuf_get_height(pixbuf) != int(size)))
+    {
+        GdkPixbuf* scaled = gdk_pixbuf_scale_simple(pixbuf, int(size),
+                                int(size), GDK_INTERP_BILINEAR);
+        g_object_unref(G_OBJECT(pixbuf));
+        pixbuf = scaled;
+    }
+    return pixbuf;
+}
+
+// Convert to the ARGB format of the _NET_WM_ICON property.
+void decode(Job* job) {
+    GdkPixbuf* pixbuf = decodeFile(job->path, job->size);
+    if (pixbuf == nullptr)
+        return;
+    const int width = gdk_pixbuf_get_width(pixbuf);
+    const int height = gdk_pixbuf_get_height(pixbuf);
+    const int nchans = gdk_pixbuf_get_n_channels(pixbuf);
+    const int stride = gdk_pixbuf_get_rowstride(pixbuf);
+    const bool alpha = gdk_pixbuf_get_has_alpha(pixbuf) && nchans == 4;
+    const guchar* pixels = gdk_pixbuf_get_pixels(pixbuf);
+    if (gdk_pixbuf_get_bits_per_sample(pixbuf) == 8 && nchans >= 3) {
+        long* argb = new long[width * height];
+        long* out = argb;
+        for (int row = 0; row < height; ++row) {
+            const guchar* pix = pixels + row * stride;
+            for (int col = 0; col < width; ++col, pix += nchans) {
+                unsigned long alp = alpha ? pix[3] : 0xFF;
+                *out++ = long(alp << 24 | pix[0] << 16 | pix[1] << 8 | pix[2]);
+            }
+        }
+        job->pixels = argb;
+        job->width = unsigned(width);
+        job->height = unsigned(height);
+    }
+    g_object_unref(G_OBJECT(pixbuf));
+}
+
+const int maxThreads = 4;
+
+class Loader : private YPollBase {
+public:
+    Loader();
+    ~Loader();
+
+    bool request(YIcon* icon, unsigned size, const char* path,
+                 YWindow* window);
+    bool pending(YIcon* icon, unsigned size, YWindow* window);
+
+private:
+    // Jobs from fQueue go to the threads, then to fDone.
+    YArray<Job*> fQueue;
+    YArray<Job*> fDone;
+    // All jobs which did not come back yet, for pending.
+    YArray<Job*> fBusy;
+    GMutex fMutex;
+    GCond fCond;
+    GThread* fThreads[maxThreads];
+    int fThreadCount;
+    int fThreadLimit;
+    int fIdle;
+    bool fStopping;
+    int fPipe[2];
+    // An errno of a thread, to be reported by the main thread.
+    int fPipeError;
+
+    void notifyRead() override;
+    bool forRead() override { return true; }
+
+    void run();
+    static gpointer worker(gpointer loader);
+    void finish(Job* job);
+    void reportError();
+};
+
+Loader::Loader() :
+    fThreadCount(0),
+    fThreadLimit(clamp(int(sysconf(_SC_NPROCESSORS_ONLN)), 1, maxThreads)),
+    fIdle(0),
+    fStopping(false),
+    fPipeError(0)
+{
+    g_mutex_init(&fMutex);
+    g_cond_init(&fCond);
+    if (pipe(fPipe) == 0) {
+        for (int fd : fPipe) {
+            fcntl(fd, F_SETFL, O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        registerPoll(fPipe[0]);
+    } else {
+        fPipe[0] = fPipe[1] = -1;
+        fThreadLimit = 0;
+    }
+}
+
+Loader::~Loader() {
+    g_mutex_lock(&fMutex);
+    fStopping = true;
+    g_cond_broadcast(&fCond);
+    g_mutex_unlock(&fMutex);
+    for (int i = 0; i < fThreadCount; ++i)
+        g_thread_join(fThreads[i]);
+
+    for (Job* job : fBusy)
+        delete job;
+    closePoll();
+    if (fPipe[1] >= 0)
+        close(fPipe[1]);
+    g_cond_clear(&fCond);
+    g_mutex_clear(&fMutex);
+}
+
+bool Loader::request(YIcon* icon, unsigned size, const char* path,
+                     YWindow* window)
+{
+    if (fThreadLimit == 0)
+        return false;
+    reportError();
+
+    Job* job = new Job(icon, size, path);
+    job->windows.append(window->handle());
+    fBusy.append(job);
+
+    g_mutex_lock(&fMutex);
+    fQueue.append(job);
+    if (fIdle < fQueue.getCount() && fThreadCount < fThreadLimit) {
+        GThread* thread = g_thread_try_new("iconload", worker, this, nullptr);
+        if (thread)
+            fThreads[fThreadCount++] = thread;
+        else if (fThreadCount == 0)
+            fThreadLimit = 0;
+    }
+    g_cond_signal(&fCond);
+    g_mutex_unlock(&fMutex);
+
+    if (fThreadLimit == 0) {
+        // Without a thread no job is ever picked up. The caller draws
+        // this icon itself, and the earlier ones are failed, so that
+        // their windows repaint them without the loader.
+        fQueue.shrink(0);
+        findRemove(fBusy, job);
+        delete job;
+        while (fBusy.nonempty())
+            finish(fBusy[0]);
+        return false;
+    }
+    return true;
+}
+
+bool Loader::pending(YIcon* icon, unsigned size, YWindow* window) {
+    for (Job* job : fBusy) {
+        if (job->icon._ptr() == icon && job->size == size) {
+            Window xid = window->handle();
+            if (find(job->windows, xid) < 0)
+                job->windows.append(xid);
+            return true;
+        }
+    }
+    return false;
+}
+
+gpointer Loader::worker(gpointer loader) {
+    static_cast<Loader *>(loader)->run();
+    return nullptr;
+}
+
+void Loader::run() {
+    g_mutex_lock(&fMutex);
+    while (fStopping == false) {
+        if (fQueue.isEmpty()) {
+            ++fIdle;
+            g_cond_wait(&fCond, &fMutex);
+            --fIdle;
+            continue;
+        }
+        Job* job = fQueue[0];
+        fQueue.remove(0);
+        g_mutex_unlock(&fMutex);
+
+        decode(job);
+
+        g_mutex_lock(&fMutex);
+        fDone.append(job);
+        if (fDone.getCount() == 1) {
+            char c = 0;
+            if (write(fPipe[1], &c, 1) < 0 && errno != EAGAIN)
+                fPipeError = errno;
+        }
+    }
+    g_mutex_unlock(&fMutex);
+}
+
+void Loader::notifyRead() {
+    char buf[64];
+    while (read(fPipe[0], buf, sizeof buf) > 0) { }
+    reportError();
+
+    YArray<Job*> done;
+    g_mutex_lock(&fMutex);
+    done.swap(fDone);
+    g_mutex_unlock(&fMutex);
+
+    for (Job* job : done)
+        finish(job);
+}
+
+// Only the main thread may print.
+void Loader::reportError() {
+    g_mutex_lock(&fMutex);
+    int error = fPipeError;
+    fPipeError = 0;
+    g_mutex_unlock(&fMutex);
+    if (error) {
+        errno = error;
+        fail("icon loader pipe");
+    }
+}
+
+void Loader::finish(Job* job) {
+    findRemove(fBusy, job);
+
+    ref<YImage> image;
+    if (job->pixels)
+        image = YImage::createFromIconProperty(job->pixels,
+                                               job->width, job->height);
+    job->icon->decoded(job->size, image);
+
+    for (Window xid : job->windows) {
+        YWindow* window = windowContext.find(xid);
+        if (window && window->destroyed() == false)
+            window->repaint();
+    }
+    delete job;
+}
+
+lazy<Loader> loader;
+
+}
+
+bool YIconLoader::canDecode(const upath& path) {
+    mstring ext(path.getExtension().lower());
+#ifdef CONFIG_LIBRSVG
+    if (ext == ".svg")
+        return true;
+#endif
+#ifdef CONFIG_GDK_PIXBUF_XLIB
+    if (ext == ".png")
+        return true;
+#endif
+    return false;
+}
+
+bool YIconLoader::request(YIcon* icon, unsigned size, const upath& path,
+                          YWindow* window)
+{
+    mstring name(path.path());
+    return loader->request(icon, size, name, window);
+}
+
+bool YIconLoader::pending(YIcon* icon, unsigned size, YWindow* window) {
+    return loader && loader->pending(icon, size, window);
+}
+
+void YIconLoader::shutdown() {
+    loader = null;
+}
+
+#else
+
+bool YIconLoader::canDecode(const upath& /*path*/) {
+    return false;
+}
+
+bool YIconLoader::request(YIcon* /*icon*/, unsigned /*size*/,
+                          const upath& /*path*/, YWindow* /*window*/)
+{
+    return false;
+}
+
+bool YIconLoader::pending(YIcon* /*icon*/, unsigned /*size*/,
+                          YWindow* /*window*/)
+{
+    return false;
+}
+
+void YIconLoader::shutdown() {
+}
+
+#endif
+
+// vim: set sw=4 ts=4 et:
@@ -0,0 +1,35 @@
+#ifndef YICONLOADER_H
+#define YICONLOADER_H
+
+class YIcon;
+class YWindow;
+class upath;
+
+/*
+ * Decodes icon files on a few background threads, so that painting
+ * a menu full of icons for the first time does not stall. Only files
+ * with a thread-safe decoder qualify: SVG by librsvg and PNG by
+ * gdk-pixbuf. Finished images are announced to the main loop through
+ * a pipe. They are given to their icons and the windows which tried
+ * to draw them are repainted.
+ */
+class YIconLoader {
+public:
+    // Whether a background decoder exists for this file.
+    static bool canDecode(const upath& path);
+
+    // Queue path to be decoded for icon at size. On completion
+    // call icon->decoded and repaint window.
+    static bool request(YIcon* icon, unsigned size, const upath& path,
+                        YWindow* window);
+
+    // Whether icon at size is queued. If so, also repaint window.
+    static bool pending(YIcon* icon, unsigned size, YWindow* window);
+
+    // Stop the threads and discard all requests.
+    static void shutdown();
+};
+
+#endif
+
+// vim: set sw=4 ts=4 et:
@@ -4,6 +4,7 @@
 
 #include "yimage2.h"
 #include "yxapp.h"
+#include "yshm.h"
 
 const char* YImage::renderName() {
     return "Imlib2";
@@ -185,16 +186,13 @@ ref<YPixmap> YImage2::renderToPixmap(unsigned depth, bool premult) {
         int width = int(this->width());
         int height = int(this->height());
         Visual* visual = xapp->visualForDepth(depth);
-        XImage* image = XCreateImage(xapp->display(), visual, depth,
-                                     ZPixmap, 0, nullptr, width, height, 8, 0);
-        if (image)
-            image->data = (char *) calloc(image->bytes_per_line * height, 1);
+        XImage* image = YShm::createImage(visual, depth, width, height);
         XImage* imask = XCreateImage(xapp->display(), visual, 1,
                                      XYPixmap, 0, nullptr, width, height, 8, 0);
         if (imask)
             imask->data = (char *) calloc(imask->bytes_per_line * height, 1);
 
-        if (image && image->data && imask && imask->data) {
+        if (image && imask && imask->data) {
             const bool alpha = imlib_image_has_alpha();
             DATA32* data = imlib_image_get_data_for_reading_only();
 
@@ -224,8 +222,7 @@ ref<YPixmap> YImage2::renderToPixmap(unsigned depth, bool premult) {
             pixmap = XCreatePixmap(xapp->display(), xapp->root(),
                                    width, height, depth);
             GC gc = XCreateGC(xapp->display(), pixmap, None, None);
-            XPutImage(xapp->display(), pixmap, gc, image,
-                      0, 0, 0, 0, width, height);
+            YShm::putImage(pixmap, gc, image);
             XFreeGC(xapp->display(), gc);
 
             mask = XCreatePixmap(xapp->display(), xapp->root(),
@@ -234,10 +231,11 @@ ref<YPixmap> YImage2::renderToPixmap(unsigned depth, bool premult) {
             XPutImage(xapp->display(), mask, gc, imask,
                       0, 0, 0, 0, width, height);
             XFreeGC(xapp->display(), gc);
-
-            XDestroyImage(image);
-            XDestroyImage(imask);
         }
+        if (image)
+            YShm::destroyImage(image);
+        if (imask)
+            XDestroyImage(imask);
     }
     else {
         pixmap = XCreatePixmap(xapp->display(), xapp->root(),
@@ -4,6 +4,7 @@
 
 #include "yimage.h"
 #include "yxapp.h"
+#include "yshm.h"
 #include <stdlib.h>
 #include <gdk-pixbuf-xlib/gdk-pixbuf-xlib.h>
 
@@ -229,16 +230,13 @@ ref<YPixmap> YImageGDK::renderToPixmap(unsigned depth, bool premult) {
         int width = int(this->width());
         int height = int(this->height());
         Visual* visual = xapp->visualForDepth(depth);
-        XImage* image = XCreateImage(xapp->display(), visual, depth,
-                                     ZPixmap, 0, nullptr, width, height, 8, 0);
-        if (image)
-            image->data = (char *) calloc(image->bytes_per_line * height, 1);
+        XImage* image = YShm::createImage(visual, depth, width, height);
         XImage* imask = XCreateImage(xapp->display(), visual, 1,
                                      XYPixmap, 0, nullptr, width, height, 8, 0);
         if (imask)
             imask->data = (char *) calloc(imask->bytes_per_line * height, 1);
 
-        if (image && image->data && imask && imask->data) {
+        if (image && imask && imask->data) {
             const bool alpha = gdk_pixbuf_get_has_alpha(fPixbuf);
             const int nchans = gdk_pixbuf_get_n_channels(fPixbuf);
             const int stride = gdk_pixbuf_get_rowstride(fPixbuf);
@@ -271,8 +269,7 @@ ref<YPixmap> YImageGDK::renderToPixmap(unsigned depth, bool premult) {
             pixmap = XCreatePixmap(xapp->display(), xapp->root(),
                                    width, height, depth);
             GC gc = XCreateGC(xapp->display(), pixmap, None, None);
-            XPutImage(xapp->display(), pixmap, gc, image,
-                      0, 0, 0, 0, width, height);
+            YShm::putImage(pixmap, gc, image);
             XFreeGC(xapp->display(), gc);
 
             mask = XCreatePixmap(xapp->display(), xapp->root(),
@@ -281,10 +278,11 @@ ref<YPixmap> YImageGDK::renderToPixmap(unsigned depth, bool premult) {
             XPutImage(xapp->display(), mask, gc, imask,
                       0, 0, 0, 0, width, height);
             XFreeGC(xapp->display(), gc);
-
-            XDestroyImage(image);
-            XDestroyImage(imask);
         }
+        if (image)
+            YShm::destroyImage(image);
+        if (imask)
+            XDestroyImage(imask);
     }
     else if (depth == unsigned(xlib_rgb_get_depth())) {
         gdk_pixbuf_xlib_render_pixmap_and_mask(fPixbuf, &pixmap, &mask, ATH);
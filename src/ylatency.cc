@@ -0,0 +1,125 @@
+/*
+ * IceWM - event loop latency histograms
+ */
+#include "config.h"
+#include "ylatency.h"
+#include "yarray.h"
+#include "base.h"
+#include <X11/X.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool YLatency::fEnabled = getenv("ICEWM_LATENCY") != nullptr;
+
+namespace {
+
+// Bucket k counts values below 2^k, the last bucket all others.
+const int Buckets = 24;
+
+struct Histogram {
+    unsigned long count;
+    unsigned long total;
+    unsigned long worst;
+    unsigned long bucket[Buckets];
+
+    void add(unsigned long value) {
+        int k = 0;
+        while (k + 1 < Buckets && (value >> k))
+            ++k;
+        ++bucket[k];
+        ++count;
+        total += value;
+        worst = max(worst, value);
+    }
+
+    void dump(const char* kind, const char* name) const {
+        if (count == 0)
+            return;
+        char buf[Buckets * 12];
+        size_t len = 0;
+        int last = Buckets;
+        while (bucket[last - 1] == 0)
+            --last;
+        for (int k = 0; k < last && len < sizeof buf; ++k)
+            len += snprintf(buf + len, sizeof buf - len, "%s%lu",
+                            k ? "," : "", bucket[k]);
+        tlog("latency %s=%s count=%lu total=%lu max=%lu hist=%s",
+             kind, name, count, total, worst, buf);
+    }
+};
+
+struct Named {
+    const char* name;
+    Histogram hist;
+};
+
+Histogram events[LASTEvent + 1];
+Histogram timers, lateness, depths;
+YObjectArray<Named> handlers;
+
+unsigned long micros(timeval t) {
+    return t.tv_sec < 0 ? 0UL : t.tv_sec * 1000000UL + t.tv_usec;
+}
+
+// Class names come from typeid, which gives one string per class.
+Histogram& handler(const char* name) {
+    for (Named* n : handlers)
+        if (n->name == name || 0 == strcmp(n->name, name))
+            return n->hist;
+    Named* n = new Named();
+    n->name = name;
+    handlers.append(n);
+    return n->hist;
+}
+
+}
+
+void YLatency::event(int type, const char* klass, timeval spent) {
+    unsigned long usec = micros(spent);
+    events[inrange(type, 0, int(LASTEvent)) ? type : LASTEvent].add(usec);
+    if (klass)
+        handler(klass).add(usec);
+}
+
+void YLatency::poll(const char* klass, timeval spent) {
+    handler(klass).add(micros(spent));
+}
+
+void YLatency::timer(timeval late, timeval spent) {
+    lateness.add(micros(late));
+    timers.add(micros(spent));
+}
+
+void YLatency::queue(int depth) {
+    depths.add(depth > 0 ? depth : 0);
+}
+
+void YLatency::dumpStatistics() {
+    if (fEnabled == false) {
+        fEnabled = true;
+        tlog("latency recording started");
+        return;
+    }
+    char name[16];
+    for (int type = 0; type <= LASTEvent; ++type) {
+        snprintf(name, sizeof name, "%d", type);
+        events[type].dump("event", name);
+    }
+    for (const Named* n : handlers) {
+        char* klass = demangle(n->name);
+        n->hist.dump("class", klass);
+        free(klass);
+    }
+    timers.dump("timer", "handler");
+    lateness.dump("timer", "late");
+    depths.dump("queue", "depth");
+
+    memset(events, 0, sizeof events);
+    memset(&timers, 0, sizeof timers);
+    memset(&lateness, 0, sizeof lateness);
+    memset(&depths, 0, sizeof depths);
+    handlers.clear();
+}
+
+// vim: set sw=4 ts=4 et:
@@ -0,0 +1,36 @@
+#ifndef YLATENCY_H
+#define YLATENCY_H
+
+#include "ytime.h"
+
+/*
+ * Opt-in timing of the event loop. When enabled, it records how long
+ * the handlers of X events, poll descriptors and timers take, how many
+ * events were queued and how late timers fired. Durations go into
+ * histograms with power-of-two buckets of microseconds.
+ *
+ * Recording starts when $ICEWM_LATENCY is set, or on the first dump.
+ * The dump is logged as one line per histogram of key=value pairs.
+ */
+class YLatency {
+public:
+    static bool enabled() { return fEnabled; }
+    static void enable() { fEnabled = true; }
+
+    // Record the handling of one event of an X event type
+    // for a window of the given class, as named by typeid.
+    static void event(int type, const char* klass, timeval spent);
+    static void poll(const char* klass, timeval spent);
+    static void timer(timeval late, timeval spent);
+    static void queue(int depth);
+
+    // Log all histograms and start afresh.
+    static void dumpStatistics();
+
+private:
+    static bool fEnabled;
+};
+
+#endif
+
+// vim: set sw=4 ts=4 et:
@@ -51,14 +51,12 @@ YListBox::YListBox(YScrollView *view, YWindow *aParent):
     fOffsetX(0),
     fOffsetY(0),
     fMaxWidth(0),
-    fWidestItem(-1),
     fFocusedItem(0),
     fSelectStart(-1),
     fSelectEnd(-1),
     fDragging(false),
     fSelect(false),
     fVisible(false),
-    fOutdated(false),
     fGraphics(this),
     fGradient(null)
 {
@@ -96,27 +94,30 @@ void YListBox::addBefore(YListItem *before, YListItem *item) {
 }
 
 void YListBox::insertAt(int position, YListItem *item) {
+    int width = item->getWidth();
     if (inrange(position, 0, getItemCount())) {
         fItems.insert(position, item);
+        fWidths.insert(position, width);
         if (fFocusedItem >= position)
             fFocusedItem++;
-        if (fWidestItem >= position)
-            fWidestItem++;
     } else {
         fItems.append(item);
+        fWidths.append(width);
     }
+    countWidth(width, +1);
     outdated();
 }
 
 void YListBox::addItem(YListItem *item) {
-    fItems.append(item);
-    outdated();
+    insertAt(-1, item);
 }
 
 void YListBox::removeItem(YListItem *item) {
     int index = findItem(item);
     if (index >= 0) {
+        countWidth(fWidths[index], -1);
         fItems.remove(index);
+        fWidths.remove(index);
         if (fFocusedItem > index)
             fFocusedItem--;
         else if (index == fFocusedItem) {
@@ -127,23 +128,20 @@ void YListBox::removeItem(YListItem *item) {
     }
 }
 
-void YListBox::updateItems() {
-    if (fOutdated) {
-        fMaxWidth = 0;
-        fWidestItem = -1;
-        for (IterType a(getIterator()); ++a; ) {
-            int width = a->getWidth();
-            if (width > fMaxWidth) {
-                fMaxWidth = width;
-                fWidestItem = a.where();
-            }
-        }
-        fOutdated = false;
-    }
+// Keep the histogram of item widths. The widest width only needs
+// a search when the last item of that width shrinks or goes away.
+void YListBox::countWidth(int width, int delta) {
+    width = max(0, width);
+    if (width >= fWidthCount.getCount())
+        fWidthCount.extend(width + 1);
+    fWidthCount[width] += delta;
+    if (width > fMaxWidth && 0 < delta)
+        fMaxWidth = width;
+    while (fMaxWidth > 0 && fWidthCount[fMaxWidth] == 0)
+        fMaxWidth--;
 }
 
 int YListBox::maxWidth() {
-    updateItems();
     return fMaxWidth;
 }
 
@@ -223,13 +221,11 @@ bool YListBox::handleTimer(YTimer* timer) {
 }
 
 void YListBox::outdated() {
-    fOutdated = true;
     fTimer->setTimer(20L, this, true);
 }
 
 void YListBox::repaint() {
     if (fVisible) {
-        updateItems();
         resetScrollBars();
         fGraphics.paint();
     }
@@ -550,7 +546,7 @@ void YListBox::paintItem(Graphics &g, int n) {
 
     ref<YIcon> icon = a->getIcon();
     if (icon != null) {
-        ref<YImage> scaled = icon->getScaledIcon(getIconSize());
+        ref<YImage> scaled = icon->getScaledIcon(getIconSize(), this);
         if (scaled != null) {
             int dx = xpos + x - fOffsetX;
             int dy = y - fOffsetY + 1;
@@ -606,18 +602,25 @@ void YListBox::activateItem(YListItem *item) {
 }
 
 void YListBox::repaintItem(YListItem *item) {
+    int i = updateItem(item);
+    if (i != -1)
+        paintItem(i);
+}
+
+int YListBox::updateItem(YListItem *item) {
     int i = findItem(item);
     if (i != -1) {
-        if (i == fWidestItem) {
-            if (item->getWidth() != fMaxWidth) {
+        int width = item->getWidth();
+        if (width != fWidths[i]) {
+            int widest = fMaxWidth;
+            countWidth(fWidths[i], -1);
+            countWidth(width, +1);
+            fWidths[i] = width;
+            if (widest != fMaxWidth)
                 outdated();
-            }
         }
-        else if (item->getWidth() > fMaxWidth) {
-            outdated();
-        }
-        paintItem(i);
     }
+    return i;
 }
 
 bool YListBox::hasSelection() {//!!!fix
@@ -77,6 +77,8 @@ public:
     void focusSelectItem(int no) { setFocusedItem(no, true, false, false); }
 
     void repaintItem(YListItem *item);
+    // Recount the width of an item after its text or icon changed.
+    int updateItem(YListItem *item);
 
 private:
     YScrollBar *fVerticalScroll;
@@ -86,13 +88,11 @@ private:
     int fOffsetX;
     int fOffsetY;
     int fMaxWidth;
-    int fWidestItem;
     int fFocusedItem;
     int fSelectStart, fSelectEnd;
     bool fDragging;
     bool fSelect;
     bool fVisible;
-    bool fOutdated;
     GraphicsBuffer fGraphics;
 
     static int fAutoScrollDelta;
@@ -108,7 +108,7 @@ private:
     void paintItem(Graphics &g, int n);
     void resetScrollBars();
     void freeItems();
-    void updateItems();
+    void countWidth(int width, int delta);
     void autoScroll(int delta, const XMotionEvent *motion);
     void focusVisible();
     void ensureVisibility(int item);
@@ -119,6 +119,11 @@ private:
     typedef YArray<YListItem*> ArrayType;
     ArrayType fItems;
 
+    // The measured width of each item, parallel to fItems,
+    // and how many items there are of each width in pixels.
+    YArray<int> fWidths;
+    YArray<int> fWidthCount;
+
 protected:
     typedef ArrayType::IterType IterType;
     IterType getIterator() { return fItems.iterator(); }
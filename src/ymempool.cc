@@ -0,0 +1,113 @@
+/*
+ * IceWM - per class memory pools
+ */
+#include "config.h"
+#include "ymempool.h"
+#include "debug.h"
+#include "base.h"
+#include <stdlib.h>
+#include <new>
+
+YMemPool* YMemPool::fPools;
+
+// Blocks are aligned as malloc aligns, and hold at least a free list link.
+static const size_t poolAlign = 2 * sizeof(void *) > sizeof(long double)
+                              ? 2 * sizeof(void *) : sizeof(long double);
+
+static size_t alignedSize(size_t size) {
+    return (max(size, sizeof(void *)) + poolAlign - 1) & ~(poolAlign - 1);
+}
+
+YMemPool::YMemPool(const char* name, size_t size, unsigned perSlab) :
+    fName(name),
+    fSize(alignedSize(size)),
+    fObjectSize(size),
+    fPerSlab(max(1U, perSlab)),
+    fFree(nullptr),
+    fSlab(nullptr),
+    fSlabs(0),
+    fLive(0),
+    fPeak(0),
+    fAllocs(0),
+    fFallbacks(0),
+    fNext(fPools)
+{
+    fPools = this;
+}
+
+YMemPool::~YMemPool() {
+    for (YMemPool** p = &fPools; *p; p = &(*p)->fNext) {
+        if (*p == this) {
+            *p = fNext;
+            break;
+        }
+    }
+    // Objects may outlive the pool at exit, then leave the slabs alone.
+    if (fLive == 0) {
+        while (fSlab) {
+            Link* next = fSlab->next;
+            ::free(fSlab);
+            fSlab = next;
+        }
+    }
+}
+
+// Allocate a new slab, with a link to the previous slab in front.
+void YMemPool::grow() {
+    char* slab = static_cast<char *>(::malloc(poolAlign + fPerSlab * fSize));
+    if (slab == nullptr)
+        throw std::bad_alloc();
+
+    reinterpret_cast<Link *>(slab)->next = fSlab;
+    fSlab = reinterpret_cast<Link *>(slab);
+    fSlabs += 1;
+
+    char* block = slab + poolAlign + fPerSlab * fSize;
+    for (unsigned i = 0; i < fPerSlab; ++i) {
+        block -= fSize;
+        Link* link = reinterpret_cast<Link *>(block);
+        link->next = fFree;
+        fFree = link;
+    }
+}
+
+void* YMemPool::allocate(size_t size) {
+    if (size != fObjectSize) {
+        fFallbacks += 1;
+        return ::operator new(size);
+    }
+    if (fFree == nullptr)
+        grow();
+
+    Link* block = fFree;
+    fFree = block->next;
+    fAllocs += 1;
+    if (++fLive > fPeak)
+        fPeak = fLive;
+    return block;
+}
+
+void YMemPool::release(void* block, size_t size) {
+    if (block == nullptr)
+        return;
+    if (size != fObjectSize) {
+        ::operator delete(block);
+        return;
+    }
+    Link* link = static_cast<Link *>(block);
+    link->next = fFree;
+    fFree = link;
+    fLive -= 1;
+}
+
+void YMemPool::dumpStatistics() {
+    tlog("%-16s %6s %6s %6s %9s %9s %6s %9s", "pool", "size",
+         "live", "peak", "allocs", "fallback", "slabs", "reserved");
+    for (YMemPool* p = fPools; p; p = p->fNext) {
+        tlog("%-16s %6zu %6u %6u %9lu %9lu %6u %9zu", p->name(),
+             p->blockSize(), p->live(), p->peak(), p->allocations(),
+             p->fallbacks(), p->slabs(), p->reserved());
+    }
+}
+
+// vim: set sw=4 ts=4 et:
@@ -0,0 +1,66 @@
+#ifndef YMEMPOOL_H
+#define YMEMPOOL_H
+
+#include <stddef.h>
+
+/*
+ * A pool of equally sized blocks for objects of one class.
+ * Blocks are carved from slabs and recycled through a free list,
+ * so that the churn of short-lived windows does not fragment the heap.
+ * Requests of a different size, as for derived classes, use the heap.
+ *
+ * A class opts in by forwarding its operator new and operator delete:
+ *
+ *     static void* operator new(size_t size) { return pool.allocate(size); }
+ *     static void operator delete(void* p, size_t size) { pool.release(p, size); }
+ *     static YMemPool pool;
+ */
+class YMemPool {
+public:
+    YMemPool(const char* name, size_t size, unsigned perSlab = 16);
+    ~YMemPool();
+
+    void* allocate(size_t size);
+    void release(void* block, size_t size);
+
+    const char* name() const { return fName; }
+    size_t blockSize() const { return fSize; }
+    unsigned live() const { return fLive; }
+    unsigned peak() const { return fPeak; }
+    unsigned slabs() const { return fSlabs; }
+    unsigned long allocations() const { return fAllocs; }
+    unsigned long fallbacks() const { return fFallbacks; }
+    size_t reserved() const { return fSlabs * fPerSlab * fSize; }
+
+    // Log the statistics of all pools.
+    static void dumpStatistics();
+
+private:
+    struct Link {
+        Link* next;
+    };
+
+    const char* fName;
+    size_t fSize;
+    size_t fObjectSize;
+    unsigned fPerSlab;
+    Link* fFree;
+    Link* fSlab;
+    unsigned fSlabs;
+    unsigned fLive;
+    unsigned fPeak;
+    unsigned long fAllocs;
+    unsigned long fFallbacks;
+    YMemPool* fNext;
+
+    static YMemPool* fPools;
+
+    void grow();
+
+    YMemPool(const YMemPool&);
+    YMemPool& operator=(const YMemPool&);
+};
+
+#endif
+
+// vim: set sw=4 ts=4 et:
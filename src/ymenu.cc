@@ -57,6 +57,8 @@ YMenu::YMenu(YWindow *parent):
     fGradient(null),
     fMenusel(null)
 {
+    fScroll = 0;
+    fVirtual = false;
     paintedItem = selectedItem = -1;
     paramPos = namePos = 0;
     submenuItem = -1;
@@ -173,7 +175,18 @@ void YMenu::focusItem(int itemNo) {
         desktop->getScreenGeometry(&dx, &dy, &uw, &uh, getXiScreen());
         const int dw = int(uw), dh = int(uh);
 
-        if (selectedItem != -1) {
+        if (selectedItem != -1 && fVirtual) {
+            int l, t, r, b;
+            getOffsets(l, t, r, b);
+            int ix, iy;
+            unsigned ih;
+            findItemPos(selectedItem, ix, iy, ih);
+            if (iy < t)
+                setScroll(fScroll + iy - t);
+            else if (iy + int(ih) > int(height()) - b)
+                setScroll(fScroll + iy + int(ih) - (int(height()) - b));
+        }
+        else if (selectedItem != -1) {
             if (x() < dx || y() < dy ||
                 x() + int(width()) > dx + dw ||
                 y() + int(height()) > dy + dh)
@@ -381,7 +394,16 @@ bool YMenu::handleKey(const XKeyEvent &key) {
 }
 
 void YMenu::handleButton(const XButtonEvent &button) {
-    if (button.button == Button5) {
+    if ((button.button == Button4 || button.button == Button5) && fVirtual) {
+        if (button.type == ButtonPress && itemCount() > 0) {
+            const int fontHeight = menuFont ? menuFont->height() : 0;
+            const int stepSize = max(fontHeight, 16);
+            const int step = (button.state & ShiftMask ? 3 : 1) * stepSize;
+            hideSubmenu();
+            setScroll(fScroll + (button.button == Button5 ? step : -step));
+            focusItem(findItem(button.x_root - x(), button.y_root - y()));
+        }
+    } else if (button.button == Button5) {
         if (button.type == ButtonPress && itemCount() > 0) {
             if (inrange(button.x_root, x(), x() + int(width()) - 1)) {
                 const int itemHeight = height() / itemCount();
@@ -603,7 +625,16 @@ bool YMenu::handleAutoScroll(const XMotionEvent & /*mouse*/) {
                 px += fAutoScrollDeltaX + 1;
         }
     }
-    if (fAutoScrollDeltaY != 0) {
+    if (fAutoScrollDeltaY != 0 && fVirtual) {
+        int old = fScroll;
+        setScroll(fScroll - fAutoScrollDeltaY);
+        if (old != fScroll) {
+            int selItem = findItem(fAutoScrollMouseX - x(),
+                                   fAutoScrollMouseY - y());
+            focusItem(selItem);
+        }
+    }
+    else if (fAutoScrollDeltaY != 0) {
         if (fAutoScrollDeltaY < 0) {
             if (py + int(height()) > dy + dh)
                 py += fAutoScrollDeltaY + 1;
@@ -688,11 +719,15 @@ void YMenu::removeAll() {
         }
     }
     fItems.clear();
+    fOffsets.clear();
     // paintedItem = selectedItem = -1;
 }
 
 YMenuItem * YMenu::add(YMenuItem *item) {
-    if (item) fItems.append(item);
+    if (item) {
+        fItems.append(item);
+        fOffsets.clear();
+    }
     return item;
 }
 
@@ -703,6 +738,7 @@ YMenuItem * YMenu::add(YMenuItem *item, const char *icons) {
             item->setIcon(icon);
         }
         fItems.append(item);
+        fOffsets.clear();
     }
     return item;
 }
@@ -717,13 +753,13 @@ YMenuItem * YMenu::addSorted(YMenuItem *item, bool duplicates, bool ignoreCase)
             continue;
         else if (cmp != 0 || duplicates) {
             fItems.insert(i, item);
+            fOffsets.clear();
             return item;
         } else {
             return nullptr;
         }
     }
-    if (item) fItems.append(item);
-    return item;
+    return add(item);
 }
 
 YMenuItem *YMenu::findAction(YAction action) {
@@ -806,6 +842,39 @@ void YMenu::getArea(int &x, int &y, unsigned &w, unsigned &h) {
     h = int(height()) - 1 - y - bottom;
 }
 
+// Sum the item heights, so that item positions are found in O(log n).
+void YMenu::updateOffsets() {
+    const int count = itemCount();
+    if (fOffsets.getCount() == count + 1)
+        return;
+
+    int l, t, r, b;
+    getOffsets(l, t, r, b);
+    fOffsets.setCapacity(count + 1);
+    fOffsets.shrink(0);
+    fOffsets.append(t);
+    for (int i = 0; i < count; i++) {
+        int top, bottom, pad;
+        fOffsets.append(fOffsets[i] + getItem(i)->queryHeight(top, bottom, pad));
+    }
+}
+
+int YMenu::contentHeight() {
+    int l, t, r, b;
+    getOffsets(l, t, r, b);
+    updateOffsets();
+    return fOffsets[itemCount()] + b;
+}
+
+void YMenu::setScroll(int scroll) {
+    int limit = fVirtual ? max(0, contentHeight() - int(height())) : 0;
+    scroll = clamp(scroll, 0, limit);
+    if (scroll != fScroll) {
+        fScroll = scroll;
+        repaint();
+    }
+}
+
 int YMenu::findItemPos(int itemNo, int &x, int &y, unsigned &ih) {
     x = -1;
     y = -1;
@@ -814,38 +883,44 @@ int YMenu::findItemPos(int itemNo, int &x, int &y, unsigned &ih) {
     if (itemNo < 0 || itemNo > itemCount())
         return -1;
 
-    unsigned w, h;
-    int top, bottom, pad;
-
-    getArea(x, y, w, h);
-    for (int i = 0; i < itemNo; i++) {
-        y += getItem(i)->queryHeight(top, bottom, pad);
-    }
+    int l, t, r, b;
+    getOffsets(l, t, r, b);
+    updateOffsets();
+    x = l;
+    y = fOffsets[itemNo] - fScroll;
     if (itemNo < itemCount())
-        ih = getItem(itemNo)->queryHeight(top, bottom, pad);
+        ih = unsigned(fOffsets[itemNo + 1] - fOffsets[itemNo]);
 
     return 0;
 }
 
-int YMenu::findItem(int mx, int my) {
-    int x, y;
-    unsigned w, h;
-
-    getArea(x, y, w, h);
-    for (int i = 0; i < itemCount(); i++, y += int(h)) {
-        int top, bottom, pad;
+// The last item which starts at or above window position my.
+int YMenu::findItemAt(int my) {
+    updateOffsets();
+    const int cy = my + fScroll;
+    int lo = 0, hi = itemCount();
+    if (hi == 0)
+        return -1;
+    while (lo + 1 < hi) {
+        int mid = (lo + hi) / 2;
+        if (fOffsets[mid] <= cy)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
 
-        h = fItems[i]->queryHeight(top, bottom, pad);
+int YMenu::findItem(int mx, int my) {
+    if (inrange(mx, 1, int(width()) - 1) == false ||
+        inrange(my, 0, int(height()) - 1) == false)
+        return -1;
 
-        if (inrange(my, y, y + int(h)) && inrange(mx, 1, int(width()) - 1)) {
-            if (!fItems[i]->isSeparator())
-                return i;
-            else
-                return -1;
-        }
-    }
+    int i = findItemAt(my);
+    if (i < 0 || !inrange(my + fScroll, fOffsets[i], fOffsets[i + 1] - 1))
+        return -1;
 
-    return -1;
+    return fItems[i]->isSeparator() ? -1 : i;
 }
 
 void YMenu::sizePopup(int hspace) {
@@ -862,22 +937,18 @@ void YMenu::sizePopup(int hspace) {
     desktop->getScreenGeometry(&dx, &dy, &uw, &uh, getXiScreen());
     int dw = int(uw);
 
-    int height = t;
+    // Items may have changed since they were added, for instance by
+    // setSubmenu, so rebuild the offsets along with the widths.
+    fOffsets.setCapacity(itemCount() + 1);
+    fOffsets.shrink(0);
+    fOffsets.append(t);
 
     for (int i = 0; i < itemCount(); i++) {
         const YMenuItem *mitem = getItem(i);
 
         int top, bottom, pad;
         int ih = mitem->queryHeight(top, bottom, pad);
-
-        if (height + ih >= 16000) {
-            // evade library bug
-            TLOG(("truncating menu to %d items at height %d", i, height));
-            fItems.shrink(i);
-            break;
-        }
-
-        height += ih;
+        fOffsets.append(fOffsets[i] + ih);
 
         if (pad > padx) padx = pad;
         if (top > left) left = top;
@@ -900,7 +971,13 @@ void YMenu::sizePopup(int hspace) {
     namePos = l + left + padx + maxIcon + 2;
     paramPos = namePos + 2 + maxName + 6;
     int width = paramPos + maxParam + 4 + r + 10;
-    height += b;
+
+    // Menus beyond the limit of window sizes fill the screen and scroll.
+    int height = contentHeight();
+    fVirtual = (height >= 16000);
+    fScroll = 0;
+    if (fVirtual)
+        height = int(uh);
 
     if (menubackPixbuf != null) {
         if (fGradient == null ||
@@ -1120,7 +1197,7 @@ void YMenu::paintItem(Graphics &g, const int i, const int l, const int t, const
                     int dx = l + 1 + delta;
                     int dy = t + delta + top + pad +
                                (eh - top - pad * 2 - bottom - size) / 2;
-                    mitem->getIcon()->draw(g, dx, dy, size);
+                    mitem->getIcon()->draw(g, dx, dy, size, this);
                 }
 
                 if (name != null) {
@@ -1225,21 +1302,33 @@ void YMenu::paint(Graphics &g, const YRect &r1) {
 
     int l, t, r, b;
     getOffsets(l, t, r, b);
-    int x, y;
-    unsigned w, h;
-    getArea(x, y, w, h);
-    int iy = y;
-    int top, bottom, pad;
+    // keep scrolled items off the border
+    if (fVirtual) {
+        YRect inner(0, t, int(width()), max(0, int(height()) - t - b));
+        YRect area(inner.intersect(r1));
+        XRectangle clip = { short(area.x()), short(area.y()),
+                            (unsigned short) area.width(),
+                            (unsigned short) area.height() };
+        g.setClipRectangles(&clip, 1);
+    }
 
-    for (int i = 0; i < itemCount(); i++) {
-        int ih = getItem(i)->queryHeight(top, bottom, pad);
+    // paint only the items which intersect the exposed area
+    int x, y;
+    unsigned ih;
+    int first = max(0, findItemAt(r1.y()));
+    for (int i = first; i < itemCount(); i++) {
+        findItemPos(i, x, y, ih);
+        if (y >= r1.y() + int(r1.height()))
+            break;
+        if (y + int(ih) > r1.y())
+            paintItem(g, i, l, y, r, r1.y(), r1.y() + r1.height(), true);
+    }
 
-        if (iy < r1.y() + (int) r1.height() &&
-            iy + (int) ih > r1.y())
-        {
-            paintItem(g, i, l, iy, r, r1.y(), r1.y() + r1.height(), true);
-        }
-        iy += ih;
+    if (fVirtual) {
+        XRectangle clip = { short(r1.x()), short(r1.y()),
+                            (unsigned short) r1.width(),
+                            (unsigned short) r1.height() };
+        g.setClipRectangles(&clip, 1);
     }
 }
 
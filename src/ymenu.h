@@ -58,7 +58,7 @@ public:
     bool lastIsSeparator() const;
     YMenuItem *lastItem() const;
     YMenuItem *getItem(int n) const { return fItems[n]; }
-    void setItem(int n, YMenuItem *ref) { fItems[n] = ref; return; }
+    void setItem(int n, YMenuItem *ref) { fItems[n] = ref; fOffsets.clear(); }
     void focusItem(int item);
 
     bool isShared() const { return fShared; }
@@ -72,6 +72,11 @@ public:
 
 private:
     YObjectArray<YMenuItem> fItems;
+    // The top of each item and the end of the last, before scrolling.
+    YArray<int> fOffsets;
+    // A virtual menu is taller than its window and scrolls its items.
+    int fScroll;
+    bool fVirtual;
     int selectedItem;
     int paintedItem;
     int paramPos;
@@ -107,10 +112,15 @@ private:
     void paintItem(Graphics &g, const int i, const int l, const int t, const int r,
                    const int minY, const int maxY, bool draw);
 
+    void updateOffsets();
+    int contentHeight();
+    void setScroll(int scroll);
+
     void repaintItem(int item);
     void paintItems();
     int findItemPos(int item, int &x, int &y, unsigned &h);
     int findItem(int x, int y);
+    int findItemAt(int y);
     int findActiveItem(int cur, int direction);
     int findHotItem(char k);
     void activateSubMenu(int item, bool byMouse);
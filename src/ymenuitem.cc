@@ -23,7 +23,7 @@ YMenuItem::YMenuItem(const mstring &name, int aHotCharPos, const mstring &param,
                      YAction action, YMenu *submenu) :
     fName(name), fParam(param), fAction(action),
     fHotCharPos(aHotCharPos), fSubmenu(submenu), fIcon(null),
-    fChecked(false), fEnabled(true) {
+    fChecked(false), fEnabled(true), fNameWidth(-1), fParamWidth(-1) {
 
     if (fName != null && (fHotCharPos == -2 || fHotCharPos == -3)) {
         int i = fName.indexOf('_');
@@ -44,12 +44,14 @@ YMenuItem::YMenuItem(const mstring &name, int aHotCharPos, const mstring &param,
 
 YMenuItem::YMenuItem(const mstring &name) :
     fName(name), fParam(null), fAction(actionNull), fHotCharPos(-1),
-    fSubmenu(nullptr), fIcon(null), fChecked(false), fEnabled(true) {
+    fSubmenu(nullptr), fIcon(null), fChecked(false), fEnabled(true),
+    fNameWidth(-1), fParamWidth(-1) {
 }
 
 YMenuItem::YMenuItem():
     fName(null), fParam(null), fAction(actionNull), fHotCharPos(-1),
-    fSubmenu(nullptr), fIcon(null), fChecked(false), fEnabled(false) {
+    fSubmenu(nullptr), fIcon(null), fChecked(false), fEnabled(false),
+    fNameWidth(-1), fParamWidth(-1) {
 }
 
 YMenuItem::~YMenuItem() {
@@ -106,14 +108,25 @@ int YMenuItem::getIconWidth() const {
     return icon != null ? YIcon::menuSize(): 0;
 }
 
+// Text widths are measured once, because the name and param never change.
 int YMenuItem::getNameWidth() const {
-    mstring name = getName();
-    return name != null && menuFont ? menuFont->textWidth(name) : 0;
+    if (fNameWidth < 0) {
+        mstring name = getName();
+        if (menuFont == null)
+            return 0;
+        fNameWidth = name != null ? menuFont->textWidth(name) : 0;
+    }
+    return fNameWidth;
 }
 
 int YMenuItem::getParamWidth() const {
-    mstring param = getParam();
-    return  param != null && menuFont ? menuFont->textWidth(param) : 0;
+    if (fParamWidth < 0) {
+        mstring param = getParam();
+        if (menuFont == null)
+            return 0;
+        fParamWidth = param != null ? menuFont->textWidth(param) : 0;
+    }
+    return fParamWidth;
 }
 
 // vim: set sw=4 ts=4 et:
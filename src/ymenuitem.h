@@ -51,6 +51,8 @@ private:
     ref<YIcon> fIcon;
     bool fChecked;
     bool fEnabled;
+    mutable int fNameWidth;
+    mutable int fParamWidth;
 };
 
 #endif
@@ -978,10 +978,119 @@ void Graphics::drawSurface(YSurface const & surface, int x, int y, unsigned w, u
     }
 }
 
+/*
+ * Scaled gradients rendered to pixmaps of the drawable depth,
+ * keyed by source image, size and depth. When the pixmaps exceed
+ * the budget, the least recently drawn ones are freed.
+ */
+class GradientCache {
+public:
+    GradientCache() : fBytes(0), fClock(0), fHits(0), fMisses(0),
+        fEvictions(0) { }
+
+    ref<YPixmap> get(ref<YImage> gradient, unsigned w, unsigned h,
+                     unsigned depth);
+    void dumpStatistics();
+
+private:
+    struct Entry {
+        ref<YImage> source;
+        ref<YPixmap> pixmap;
+        unsigned width, height, depth;
+        unsigned long used;
+        size_t bytes;
+    };
+    YObjectArray<Entry> fEntries;
+    size_t fBytes;
+    unsigned long fClock;
+    unsigned long fHits, fMisses, fEvictions;
+
+    static const size_t budget = 8 << 20;
+    void evict(size_t needed);
+};
+
+ref<YPixmap> GradientCache::get(ref<YImage> gradient, unsigned w, unsigned h,
+                                unsigned depth)
+{
+    for (Entry* e : fEntries) {
+        if (e->source == gradient && e->width == w && e->height == h &&
+            e->depth == depth)
+        {
+            e->used = ++fClock;
+            fHits++;
+            return e->pixmap;
+        }
+    }
+    fMisses++;
+
+    size_t bytes = size_t(w) * h * (depth > 16 ? 4 : 2);
+    if (bytes > budget / 4)
+        return null;
+    ref<YImage> scaled = gradient->scale(w, h);
+    if (scaled == null)
+        return null;
+    ref<YPixmap> pixmap = scaled->renderToPixmap(depth);
+    if (pixmap == null || pixmap->pixmap(depth) == None)
+        return null;
+
+    evict(bytes);
+    Entry* e = new Entry;
+    e->source = gradient;
+    e->pixmap = pixmap;
+    e->width = w;
+    e->height = h;
+    e->depth = depth;
+    e->used = ++fClock;
+    e->bytes = bytes;
+    fEntries.append(e);
+    fBytes += bytes;
+    return pixmap;
+}
+
+void GradientCache::evict(size_t needed) {
+    while (fEntries.nonempty() && fBytes + needed > budget) {
+        int lru = 0;
+        for (int i = 1; i < fEntries.getCount(); ++i)
+            if (fEntries[i]->used < fEntries[lru]->used)
+                lru = i;
+        fBytes -= fEntries[lru]->bytes;
+        fEntries.remove(lru);
+        fEvictions++;
+    }
+}
+
+void GradientCache::dumpStatistics() {
+    tlog("gradients: %d cached, %zu bytes, %lu hits, %lu misses, "
+         "%lu evictions", fEntries.getCount(), fBytes,
+         fHits, fMisses, fEvictions);
+}
+
+static GradientCache* gradientCache;
+
+void Graphics::freeGradients() {
+    delete gradientCache;
+    gradientCache = nullptr;
+}
+
+void Graphics::dumpGradientStatistics() {
+    if (gradientCache)
+        gradientCache->dumpStatistics();
+}
+
 void Graphics::drawGradient(ref<YImage> gradient,
                             int x, int y, unsigned w, unsigned h,
                             int gx, int gy, unsigned gw, unsigned gh)
 {
+    // Gradients with alpha must be composited on every paint.
+    if (gradient->hasAlpha() == false) {
+        if (gradientCache == nullptr)
+            gradientCache = new GradientCache();
+        ref<YPixmap> pixmap = gradientCache->get(gradient, gw, gh, rdepth());
+        if (pixmap != null) {
+            drawPixmap(pixmap, gx, gy, w, h, x, y);
+            return;
+        }
+    }
     ref<YImage> scaled = gradient->scale(gw, gh);
     if (scaled != null)
         scaled->draw(*this, gx, gy, w, h, x, y);
@@ -177,6 +177,8 @@ public:
                       int x, int y, unsigned w, unsigned h) {
         drawGradient(gradient, x, y, w, h, 0, 0, w, h);
     }
+    static void freeGradients();
+    static void dumpGradientStatistics();
 
     void repHorz(ref<YPixmap> p, int x, int y, unsigned w);
     void repVert(ref<YPixmap> p, int x, int y, unsigned h);
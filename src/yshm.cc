@@ -0,0 +1,182 @@
+/*
+ * IceWM - image upload through shared memory
+ */
+#include "config.h"
+#include "yshm.h"
+#include "yxapp.h"
+#include "yarray.h"
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool YShm::fFailed;
+
+namespace {
+
+// Smaller images are not worth a segment.
+const size_t Threshold = 64 * 1024;
+// How much the pool keeps when it is not in use.
+const int MaxFree = 4;
+const size_t MaxFreeBytes = 16 * 1024 * 1024;
+
+struct Segment {
+    XShmSegmentInfo info;
+    size_t size;
+    unsigned long serial;
+    bool used;
+};
+
+YObjectArray<Segment> segments;
+bool attachError;
+
+int attachHandler(Display*, XErrorEvent*) {
+    attachError = true;
+    return 0;
+}
+
+void destroy(int index) {
+    Segment* seg = segments[index];
+    XShmDetach(xapp->display(), &seg->info);
+    shmdt(seg->info.shmaddr);
+    segments.remove(index);
+}
+
+// The server must attach to a new segment before it is marked for
+// removal, and a remote server cannot attach at all. Learn both now.
+Segment* create(size_t size, bool* failed) {
+    int id = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (id == -1)
+        return nullptr;
+    void* addr = shmat(id, nullptr, 0);
+    if (addr == reinterpret_cast<void *>(-1)) {
+        shmctl(id, IPC_RMID, nullptr);
+        return nullptr;
+    }
+
+    Segment* seg = new Segment();
+    seg->info.shmid = id;
+    seg->info.shmaddr = static_cast<char *>(addr);
+    seg->info.readOnly = True;
+    seg->size = size;
+
+    Display* dpy = xapp->display();
+    XSync(dpy, False);
+    attachError = false;
+    XErrorHandler old = XSetErrorHandler(attachHandler);
+    Bool attached = XShmAttach(dpy, &seg->info);
+    XSync(dpy, False);
+    XSetErrorHandler(old);
+    shmctl(id, IPC_RMID, nullptr);
+
+    if (attached == False || attachError) {
+        shmdt(addr);
+        delete seg;
+        *failed = true;
+        return nullptr;
+    }
+    segments.append(seg);
+    return seg;
+}
+
+// The smallest free segment which fits, once the server is done with it.
+Segment* acquire(size_t size, bool* failed) {
+    Segment* best = nullptr;
+    for (Segment* seg : segments) {
+        if (seg->used == false && size <= seg->size &&
+            (best == nullptr || seg->size < best->size))
+            best = seg;
+    }
+    if (best) {
+        Display* dpy = xapp->display();
+        if (LastKnownRequestProcessed(dpy) < best->serial)
+            XSync(dpy, False);
+    } else {
+        best = create(size, failed);
+    }
+    if (best)
+        best->used = true;
+    return best;
+}
+
+int find(const XImage* image) {
+    for (int i = 0; i < segments.getCount(); ++i)
+        if (image->obdata == (char *) &segments[i]->info)
+            return i;
+    return -1;
+}
+
+void release(int index) {
+    segments[index]->used = false;
+
+    int count = 0;
+    size_t bytes = 0;
+    for (Segment* seg : segments) {
+        if (seg->used == false) {
+            count += 1;
+            bytes += seg->size;
+        }
+    }
+    if (MaxFree < count || MaxFreeBytes < bytes)
+        destroy(index);
+}
+
+}
+
+XImage* YShm::createImage(Visual* visual, unsigned depth,
+                          unsigned width, unsigned height)
+{
+    Display* dpy = xapp->display();
+    if (xshm.supported && fFailed == false) {
+        XImage* image = XShmCreateImage(dpy, visual, depth, ZPixmap,
+                                        nullptr, nullptr, width, height);
+        if (image) {
+            size_t size = size_t(image->bytes_per_line) * height;
+            Segment* seg = Threshold <= size ? acquire(size, &fFailed) : nullptr;
+            if (seg) {
+                image->data = seg->info.shmaddr;
+                image->obdata = (char *) &seg->info;
+                memset(image->data, 0, size);
+                return image;
+            }
+            XDestroyImage(image);
+        }
+    }
+
+    XImage* image = XCreateImage(dpy, visual, depth, ZPixmap, 0, nullptr,
+                                 width, height, 8, 0);
+    if (image) {
+        image->data = (char *) calloc(image->bytes_per_line, height);
+        if (image->data == nullptr) {
+            XDestroyImage(image);
+            image = nullptr;
+        }
+    }
+    return image;
+}
+
+void YShm::putImage(Drawable drawable, GC gc, XImage* image) {
+    Display* dpy = xapp->display();
+    int index = image->obdata ? find(image) : -1;
+    if (index >= 0) {
+        segments[index]->serial = NextRequest(dpy);
+        XShmPutImage(dpy, drawable, gc, image, 0, 0, 0, 0,
+                     image->width, image->height, False);
+    } else {
+        XPutImage(dpy, drawable, gc, image, 0, 0, 0, 0,
+                  image->width, image->height);
+    }
+}
+
+void YShm::destroyImage(XImage* image) {
+    int index = image->obdata ? find(image) : -1;
+    if (index >= 0) {
+        release(index);
+        image->data = nullptr;
+        image->obdata = nullptr;
+    }
+    XDestroyImage(image);
+}
+
+// vim: set sw=4 ts=4 et:
@@ -0,0 +1,30 @@
+#ifndef YSHM_H
+#define YSHM_H
+
+#include <X11/Xlib.h>
+
+/*
+ * Images for upload to a drawable. When the X server supports MIT-SHM
+ * and shares memory with us, large images live in a shared segment and
+ * are uploaded by XShmPutImage, which copies nothing through the socket.
+ * Otherwise they are ordinary images which go through XPutImage.
+ *
+ * Segments are kept in a small pool for reuse. A segment is handed out
+ * again only after the server has processed the last upload from it.
+ */
+class YShm {
+public:
+    // A zero filled ZPixmap image of the given size and depth.
+    static XImage* createImage(Visual* visual, unsigned depth,
+                               unsigned width, unsigned height);
+    // Copy the whole image to the drawable.
+    static void putImage(Drawable drawable, GC gc, XImage* image);
+    static void destroyImage(XImage* image);
+
+private:
+    static bool fFailed;
+};
+
+#endif
+
+// vim: set sw=4 ts=4 et:
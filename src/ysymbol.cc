@@ -0,0 +1,139 @@
+/*
+ * IceWM - interned strings
+ */
+#include "config.h"
+#include "ysymbol.h"
+#include <string.h>
+#include <stdlib.h>
+#include <new>
+
+static const char* emptyStrings[1] = { "" };
+
+const char** YSymbol::fStrings = emptyStrings;
+unsigned* YSymbol::fTable;
+unsigned YSymbol::fCount = 1;
+unsigned YSymbol::fSize;
+
+static unsigned hashOf(const char* str, size_t len) {
+    unsigned long hash = 5381;
+    for (size_t i = 0; i < len; ++i)
+        hash = 33 * hash ^ (unsigned char) str[i];
+    return unsigned(hash);
+}
+
+namespace {
+
+// Concatenate up to three strings, which may be null.
+class Concat {
+public:
+    Concat(const char* str1, const char* str2, const char* str3) {
+        size_t len1 = str1 ? strlen(str1) : 0;
+        size_t len2 = str2 ? strlen(str2) : 0;
+        size_t len3 = str3 ? strlen(str3) : 0;
+        len = len1 + len2 + len3;
+        buf = len < sizeof local ? local : new char[len + 1];
+        // A null source is undefined for memcpy, even at length zero.
+        if (len1)
+            memcpy(buf, str1, len1);
+        if (len2)
+            memcpy(buf + len1, str2, len2);
+        if (len3)
+            memcpy(buf + len1 + len2, str3, len3);
+        buf[len] = '\0';
+    }
+    ~Concat() {
+        if (buf != local)
+            delete[] buf;
+    }
+    char* buf;
+    size_t len;
+private:
+    char local[256];
+};
+
+}
+
+YSymbol::YSymbol(const char* str1, const char* str2, const char* str3) {
+    Concat cat(str1, str2, str3);
+    fIndex = intern(cat.buf, cat.len);
+}
+
+YSymbol YSymbol::find(const char* str) {
+    YSymbol sym;
+    unsigned slot;
+    if (str && *str)
+        sym.fIndex = lookup(str, strlen(str), &slot);
+    return sym;
+}
+
+YSymbol YSymbol::find(const char* str1, const char* str2, const char* str3) {
+    Concat cat(str1, str2, str3);
+    YSymbol sym;
+    unsigned slot;
+    if (cat.len)
+        sym.fIndex = lookup(cat.buf, cat.len, &slot);
+    return sym;
+}
+
+// Double the hash table and the string array, and reinsert all symbols.
+void YSymbol::rehash() {
+    unsigned size = fSize ? 2 * fSize : 64;
+    unsigned* table = static_cast<unsigned *>(calloc(size, sizeof(unsigned)));
+    const char** strings = static_cast<const char **>(
+        malloc(size * sizeof(const char *)));
+    if (table == nullptr || strings == nullptr)
+        throw std::bad_alloc();
+
+    memcpy(strings, fStrings, fCount * sizeof(const char *));
+    for (unsigned index = 1; index < fCount; ++index) {
+        const char* str = strings[index];
+        unsigned slot = hashOf(str, strlen(str)) & (size - 1);
+        while (table[slot])
+            slot = (slot + 1) & (size - 1);
+        table[slot] = index;
+    }
+
+    if (fStrings != emptyStrings)
+        free(fStrings);
+    free(fTable);
+    fStrings = strings;
+    fTable = table;
+    fSize = size;
+}
+
+// The index of an interned string, or zero. Also give the slot
+// in the hash table where it is, or where it would be inserted.
+unsigned YSymbol::lookup(const char* str, size_t len, unsigned* slot) {
+    if (fSize == 0)
+        return 0;
+    *slot = hashOf(str, len) & (fSize - 1);
+    for (; fTable[*slot]; *slot = (*slot + 1) & (fSize - 1)) {
+        const char* sym = fStrings[fTable[*slot]];
+        if (0 == strncmp(sym, str, len) && sym[len] == '\0')
+            return fTable[*slot];
+    }
+    return 0;
+}
+
+unsigned YSymbol::intern(const char* str, size_t len) {
+    if (str == nullptr || len == 0)
+        return 0;
+    if (2 * fCount >= fSize)
+        rehash();
+
+    unsigned slot = 0;
+    unsigned index = lookup(str, len, &slot);
+    if (index)
+        return index;
+
+    char* copy = static_cast<char *>(malloc(len + 1));
+    if (copy == nullptr)
+        throw std::bad_alloc();
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    fStrings[fCount] = copy;
+    fTable[slot] = fCount;
+    return fCount++;
+}
+
+// vim: set sw=4 ts=4 et:
@@ -0,0 +1,55 @@
+#ifndef YSYMBOL_H
+#define YSYMBOL_H
+
+#include <string.h>
+
+/*
+ * An interned string. Equal strings map to the same symbol,
+ * which is an index into a global table of unique strings.
+ * Symbols compare as integers. The null string and the empty
+ * string both give the empty symbol, which has index zero.
+ * Interned strings live until the program exits, so only intern
+ * strings which are kept. Use find to look up transient strings.
+ */
+class YSymbol {
+public:
+    YSymbol() : fIndex(0) { }
+    explicit YSymbol(const char* str) :
+        fIndex(intern(str, str ? strlen(str) : 0)) { }
+    YSymbol(const char* str, size_t len) : fIndex(intern(str, len)) { }
+    // Intern the concatenation of three strings, which may be null.
+    YSymbol(const char* str1, const char* str2, const char* str3);
+
+    unsigned index() const { return fIndex; }
+    const char* c_str() const { return fStrings[fIndex]; }
+    bool isEmpty() const { return fIndex == 0; }
+    bool nonempty() const { return fIndex != 0; }
+
+    bool operator==(YSymbol sym) const { return fIndex == sym.fIndex; }
+    bool operator!=(YSymbol sym) const { return fIndex != sym.fIndex; }
+    bool operator<(YSymbol sym) const { return fIndex < sym.fIndex; }
+
+    // The symbol of a string, or the empty symbol when the string
+    // was never interned. Does not add to the table.
+    static YSymbol find(const char* str);
+    static YSymbol find(const char* str1, const char* str2, const char* str3);
+
+    // The number of symbols, including the empty symbol.
+    static unsigned count() { return fCount; }
+
+private:
+    unsigned fIndex;
+
+    static unsigned intern(const char* str, size_t len);
+    static unsigned lookup(const char* str, size_t len, unsigned* slot);
+    static void rehash();
+
+    static const char** fStrings;
+    static unsigned* fTable;
+    static unsigned fCount;
+    static unsigned fSize;
+};
+
+#endif
+
+// vim: set sw=4 ts=4 et:
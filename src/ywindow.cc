@@ -598,7 +598,6 @@ void YWindow::handleEvent(const XEvent &event) {
                      XPutBackEvent(xapp->display(), &new_event);
                      break;
                  } else {
-                     xapp->sync();
                      old_event = new_event;
                  }
              }
@@ -388,6 +388,7 @@ extern YExtension shapes;
 extern YExtension xrandr;
 extern YExtension xinerama;
 extern YExtension xshm;
+extern YExtension xsync;
 
 extern Atom _XA_WM_CHANGE_STATE;
 extern Atom _XA_WM_CLASS;
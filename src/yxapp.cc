@@ -7,6 +7,7 @@
 #include "ypointer.h"
 #include "yxcontext.h"
 #include "guievent.h"
+#include "ylatency.h"
 #include "intl.h"
 #undef override
 #include <X11/Xproto.h>
@@ -15,6 +16,8 @@
 #endif
 #include <X11/extensions/Xcomposite.h>
 #include <X11/extensions/XShm.h>
+#include <X11/extensions/sync.h>
+#include <typeinfo>
 
 YXApplication *xapp = nullptr;
 
@@ -195,6 +198,7 @@ YExtension shapes;
 YExtension xrandr;
 YExtension xinerama;
 YExtension xshm;
+YExtension xsync;
 
 #ifdef DEBUG
 int xeventcount = 0;
@@ -1106,6 +1110,7 @@ void YXApplication::initExtensions(Display* dpy) {
 #endif
 
     xshm.init(dpy, XShmQueryExtension, XShmQueryVersion);
+    xsync.init(dpy, XSyncQueryExtension, XSyncInitialize);
 }
 
 YXApplication::~YXApplication() {
@@ -1122,6 +1127,9 @@ bool YXApplication::handleXEvents() {
     int retrieved = 0;
     for (; retrieved < XPending(display()); retrieved += prratio - 1) {
         XEvent xev;
+        const bool timing = YLatency::enabled();
+        if (timing)
+            YLatency::queue(QLength(display()));
 
         XNextEvent(display(), &xev);
 #ifdef DEBUG
@@ -1131,6 +1139,15 @@ bool YXApplication::handleXEvents() {
 
         saveEventTime(xev);
 
+        const char* klass = nullptr;
+        timeval start = zerotime();
+        if (timing) {
+            YWindow* target = nullptr;
+            if (windowContext.find(xev.xany.window, &target) && target)
+                klass = typeid(*target).name();
+            start = monotime();
+        }
+
 #if LOGEVENTS
         if (loggingEvents) {
             if (xev.type < LASTEvent)
@@ -1179,6 +1196,8 @@ bool YXApplication::handleXEvents() {
             }
         }
         XFlush(display());
+        if (timing)
+            YLatency::event(xev.type, klass, monotime() - start);
     }
     return retrieved > 0;
 }
@@ -1343,7 +1362,7 @@ void YProperty::discard() {
 const YProperty& YProperty::update() {
     discard();
     int fmt = 0;
-    if (XGetWindowProperty(xapp->display(), fWind, fProp, 0L, fLimit, fDelete,
+    if (XGetWindowProperty(xapp->display(), fWind, fProp, fOffset, fLimit, fDelete,
                            fKind, &fType, &fmt, &fSize, &fMore, &fData) ==
         Success && fData && fSize && fmt == fBits && (fKind == fType || !fKind))
     {
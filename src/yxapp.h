@@ -37,16 +37,19 @@ enum YFormat { F8 = 8, F16 = 16, F32 = 32 };
 class YProperty {
 public:
     YProperty(YWindow* window, Atom prop, YFormat format = F32,
-              long limit = 1L, Atom type = AnyPropertyType, bool remove = False):
+              long limit = 1L, Atom type = AnyPropertyType, bool remove = False,
+              long offset = 0L):
         fWind(window->handle()), fData(nullptr), fProp(prop), fKind(type),
-        fType(None), fLimit(limit), fSize(None), fMore(None), fBits(format),
-        fDelete(remove)
+        fType(None), fOffset(offset), fLimit(limit), fSize(None), fMore(None),
+        fBits(format), fDelete(remove)
     { update(); }
 
     YProperty(Window handle, Atom prop, YFormat format = F32,
-              long limit = 1L, Atom type = AnyPropertyType, bool remove = False):
+              long limit = 1L, Atom type = AnyPropertyType, bool remove = False,
+              long offset = 0L):
         fWind(handle), fData(nullptr), fProp(prop), fKind(type), fType(None),
-        fLimit(limit), fSize(None), fMore(None), fBits(format), fDelete(remove)
+        fOffset(offset), fLimit(limit), fSize(None), fMore(None),
+        fBits(format), fDelete(remove)
     { update(); }
 
     ~YProperty() { discard(); }
@@ -79,6 +82,7 @@ private:
     Atom fProp;
     Atom fKind;
     Atom fType;
+    long fOffset;
     long fLimit;
     unsigned long fSize;
     unsigned long fMore;
@@ -13,6 +13,7 @@
 
 #include "yimage.h"
 #include "yxapp.h"
+#include "yshm.h"
 #include "ypointer.h"
 #include "intl.h"
 
@@ -1094,17 +1095,21 @@ ref <YPixmap> YXImage::renderToPixmap(unsigned depth, bool premult)
                 for (unsigned i = 0; !has_mask && i < w; i++)
                     if (((XGetPixel(fImage, i, j) >> 24) & 0xff) < 128)
                         has_mask = true;
-        if (hasAlpha() || depth != this->depth()) {
-            xdraw = createImage(w, h, depth);
-            if (xdraw == 0) {
-                goto error;
-            }
+        xdraw = YShm::createImage(xapp->visualForDepth(depth), depth, w, h);
+        if (xdraw == 0) {
+            tlog("ERROR: could not create %ux%ux%u ximage", w, h, depth);
+            goto error;
+        }
+        if (hasAlpha() == false && depth == this->depth() &&
+            xdraw->bytes_per_line == fImage->bytes_per_line &&
+            xdraw->bits_per_pixel == fImage->bits_per_pixel &&
+            xdraw->byte_order == fImage->byte_order)
+        {
+            memcpy(xdraw->data, fImage->data, size_t(xdraw->bytes_per_line) * h);
+        } else {
             for (unsigned j = 0; j < h; j++)
                 for (unsigned i = 0; i < w; i++)
                     XPutPixel(xdraw, i, j, XGetPixel(fImage, i, j));
-        } else if (!(xdraw = XSubImage(fImage, 0, 0, w, h))) {
-            tlog("ERROR: could not create subimage %ux%u\n", w, h);
-            goto error;
         }
         // tlog("created ximage %ux%ux%u for pixmap\n", xdraw->width, xdraw->height, xdraw->depth);
 
@@ -1134,7 +1139,7 @@ ref <YPixmap> YXImage::renderToPixmap(unsigned depth, bool premult)
         }
         // tlog("putting ximage %ux%ux%u to pixmap\n", xdraw->width, xdraw->height, xdraw->depth);
         // tlog("next request %lu at %s: +%d : %s()\n", NextRequest(xapp->display()), __FILE__, __LINE__, __func__);
-        XPutImage(xapp->display(), draw, gcd, xdraw, 0, 0, 0, 0, xdraw->width, xdraw->height);
+        YShm::putImage(draw, gcd, xdraw);
 
         // tlog("next request %lu at %s: +%d : %s()\n", NextRequest(xapp->display()), __FILE__, __LINE__, __func__);
         mask = XCreatePixmap(xapp->display(), xapp->root(), xmask->width, xmask->height, 1);
@@ -1174,7 +1179,7 @@ ref <YPixmap> YXImage::renderToPixmap(unsigned depth, bool premult)
         XDestroyImage(xmask);
     }
     if (xdraw) {
-        XDestroyImage(xdraw);
+        YShm::destroyImage(xdraw);
     }
     return pixmap;
 }
@@ -58,7 +58,7 @@ static bool windowDestroyed(Window win) {
 }
 
 static int getOrder(mstring title) {
-    WindowOption opt(title);
+    WindowOption opt;
     if (hintOptions)
         hintOptions->mergeWindowOption(opt, title, true);
     if (defOptions)
@@ -578,6 +578,7 @@ YXTray::YXTray(YXTrayNotifier *notifier,
     fTrayProxy(nullptr),
     fNotifier(notifier),
     fLocked(false),
+    fPublish(false),
     fRunProxy(internal == false),
     fTrace(YTrace::traces("systray")),
     fDrawBevel(drawBevel)
@@ -770,15 +771,18 @@ void YXTray::backgroundChanged() {
     }
 }
 
+// Liveness comes from DestroyNotify and XEmbed events on the clients,
+// so a relayout asks nothing from the server. YWindow::setGeometry
+// only sends requests for rectangles which really change.
 void YXTray::relayout(bool enforced) {
     if (fLocked)
         return;
     Lock lock(&fLocked);
 
+    const unsigned long request = trace() ? NextRequest(xapp->display()) : 0;
     int aw = 0;
     int countVisible = 0;
     const unsigned h = trayIconMaxHeight + fDrawBevel;
-    XWindowAttributes attr;
 
     for (IterType ec = fDocked.reverseIterator(); ++ec; ) {
         if (ec->client()->destroyed()) {
@@ -790,48 +794,44 @@ void YXTray::relayout(bool enforced) {
         }
     }
 
-    if (enforced == false)
-        return;
+    if (enforced) {
+        for (IterType ec = fDocked.iterator(); ++ec; ) {
+            if (ec->fVisible) {
+                int eh = h - fDrawBevel;
+                int ew = ec->width();
+                int ay = fDrawBevel;
+                aw = max(int(fDrawBevel), aw);
+                ec->setGeometry(YRect(aw, ay, ew, eh));
+                ec->client()->setGeometry(YRect(0, 0, ew, eh));
+                aw += ew;
+                countVisible++;
+            }
+        }
+        aw += fDrawBevel;
 
-    for (IterType ec = fDocked.iterator(); ++ec; ) {
-        if (false == ec->fVisible) {
-            // skip
+        unsigned w = aw;
+        if (fRunProxy) {
+            if (w < 1)
+                w = 1;
         }
-        else if (ec->client()->getWindowAttributes(&attr)) {
-            int eh = h - fDrawBevel;
-            int ew = ec->width();
-            int ay = fDrawBevel;
-            aw = max(int(fDrawBevel), aw);
-            ec->setGeometry(YRect(aw, ay, ew, eh));
-            ec->client()->setGeometry(YRect(0, 0, ew, eh));
-            aw += ew;
-            countVisible++;
+        if (fDrawBevel) {
+            if (w < 4)
+                w = 0;
         }
-        else {
-            if (trace())
-                tlog("systray sanity remove %08lx", ec->client_handle());
-            ec.remove();
-            updateTrayWindows();
-            --ec;
+        trayUpdateGeometry(w, h, countVisible > 0);
+
+        for (IterType ec = fDocked.iterator(); ++ec; ) {
+            if (ec->fVisible)
+                ec->show();
         }
     }
-    aw += fDrawBevel;
 
-    unsigned w = aw;
-    if (fRunProxy) {
-        if (w < 1)
-            w = 1;
-    }
-    if (fDrawBevel) {
-        if (w < 4)
-            w = 0;
-    }
-    trayUpdateGeometry(w, h, countVisible > 0);
+    publishTrayWindows();
 
-    for (IterType ec = fDocked.iterator(); ++ec; ) {
-        if (ec->fVisible)
-            ec->show();
-    }
+    if (trace() && enforced)
+        tlog("systray relayout %d clients, %d visible, %lu requests",
+             fDocked.getCount(), countVisible,
+             NextRequest(xapp->display()) - request);
 
     MSG(("clients %d width: %d, visible %s",
          fDocked.getCount(), width(), boolstr(visible())));
@@ -853,13 +853,31 @@ void YXTray::trayUpdateGeometry(unsigned w, unsigned h, bool visible) {
     }
 }
 
+// Changes to the docked clients are collected until the next relayout,
+// which sets _KDE_NET_SYSTEM_TRAY_WINDOWS once if the list differs.
 void YXTray::updateTrayWindows() {
+    fPublish = true;
+    if (fLocked == false)
+        publishTrayWindows();
+}
+
+void YXTray::publishTrayWindows() {
+    if (fPublish == false)
+        return;
+    fPublish = false;
+
     const int count = fDocked.getCount();
-    Window windows[count];
+    bool same = (count == fPublished.getCount());
+    for (IterType ec = fDocked.iterator(); same && ++ec; )
+        same = (fPublished[ec.where()] == ec->leader());
+    if (same)
+        return;
 
+    fPublished.clear();
     for (IterType ec = fDocked.iterator(); ++ec; )
-        windows[ec.where()] = ec->leader();
+        fPublished.append(ec->leader());
 
+    Window* windows = count ? &*fPublished : nullptr;
     desktop->setProperty(_XA_KDE_NET_SYSTEM_TRAY_WINDOWS, XA_WINDOW,
                          windows, count);
 }
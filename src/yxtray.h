@@ -101,6 +101,7 @@ private:
     static void getScaleSize(unsigned& w, unsigned& h);
     Window getLeader(Window win);
     void trayUpdateGeometry(unsigned w, unsigned h, bool visible);
+    void publishTrayWindows();
 
     YXTrayProxy *fTrayProxy;
     typedef YObjectArray<YXTrayEmbedder> DockedType;
@@ -108,8 +109,10 @@ private:
     DockedType fDocked;
     YXTrayNotifier *fNotifier;
     YArray<Window> fRegained;
+    YArray<Window> fPublished;
     YRect fGeometry;
     bool fLocked;
+    bool fPublish;
     bool fRunProxy;
     bool fTrace;
     bool fDrawBevel;